@@ -22,6 +22,8 @@ void AppConfig::loadDefaults() {
     // Reset internal 'current' values to defaults before loading/saving
     m_currentWeights = m_defaultWeights;
     m_currentMctsTimeLimit = m_defaultMctsTimeLimit;
+    m_currentRankFloor = m_defaultRankFloor;
+    m_currentMctsLeafEvaluation = parseMctsLeafEvaluation(m_defaultMctsLeafEvaluation);
     // Other defaults are read directly when needed using value() with fallback
 }
 
@@ -32,6 +34,8 @@ void AppConfig::load() {
     // Read directly via getters using value() - example:
     // double loadedSmoothingK = m_settings.value("SmoothingK", m_defaultSmoothingK).toDouble();
     m_currentMctsTimeLimit = m_settings.value("MctsTimeLimit", m_defaultMctsTimeLimit).toDouble();
+    m_currentRankFloor = std::max(0, m_settings.value("RankFloor", m_defaultRankFloor).toInt());
+    m_currentMctsLeafEvaluation = parseMctsLeafEvaluation(m_settings.value("MctsLeafEvaluation", m_defaultMctsLeafEvaluation).toString());
     // Exploration, Result Count, Interval getters read directly from m_settings
     m_settings.endGroup();
 
@@ -42,6 +46,7 @@ void AppConfig::load() {
     m_currentWeights.pickRate = m_settings.value("PickRate", m_defaultWeights.pickRate).toDouble();
     m_settings.endGroup();
 
+    ++m_version;
     qInfo() << "Configuration loaded from" << m_settings.fileName();
 }
 
@@ -53,6 +58,8 @@ void AppConfig::save() {
     m_settings.setValue("MinRank", minRank());
     m_settings.setValue("MaxRankConsidered", maxRankConsidered());
     m_settings.setValue("RankWeightDivisor", rankWeightScaleDivisor());
+    m_settings.setValue("RankFloor", m_currentRankFloor);
+    m_settings.setValue("RankCeiling", rankCeiling());
     m_settings.setValue("LowPickRateThreshold", lowPickRateThreshold());
     m_settings.setValue("LowConfidenceWinRateTarget", lowConfidenceWinRateTarget());
     // Save the potentially updated values stored in members
@@ -60,6 +67,14 @@ void AppConfig::save() {
     m_settings.setValue("MctsExplorationParam", mctsExplorationParam());
     m_settings.setValue("MctsResultCount", mctsResultCount());
     m_settings.setValue("MctsUpdateIntervalIters", mctsUpdateIntervalIters());
+    m_settings.setValue("MctsThreads", mctsThreads());
+    m_settings.setValue("MctsVirtualLoss", mctsVirtualLoss());
+    m_settings.setValue("MctsParallelMode", mctsParallelMode() == MctsParallelMode::RootParallel ? "RootParallel" : "SharedTree");
+    m_settings.setValue("MctsLeafEvaluation", mctsLeafEvaluationName(m_currentMctsLeafEvaluation));
+    m_settings.setValue("MctsSelection", mctsSelection() == MctsSelection::PUCT ? "PUCT" : "UCT");
+    m_settings.setValue("MctsWidening", mctsWidening());
+    m_settings.setValue("MctsMemoryBudgetMB", mctsMemoryBudgetMB());
+    m_settings.setValue("StatsMemoryBudgetMB", statsMemoryBudgetMB());
     m_settings.endGroup();
 
     m_settings.beginGroup("Weights");
@@ -95,6 +110,16 @@ double AppConfig::rankWeightScaleDivisor() const {
     return (divisor <= 0) ? 1.0 : divisor; // Return 1.0 if config value is invalid
 }
 
+int AppConfig::rankFloor() const {
+    // Return the 'current' floor loaded/defaulted/set (the UI can change it)
+    return m_currentRankFloor;
+}
+
+int AppConfig::rankCeiling() const {
+    int ceiling = m_settings.value("Settings/RankCeiling", m_defaultRankCeiling).toInt();
+    return std::max(0, ceiling); // 0 (or negative) = no ceiling
+}
+
 
 double AppConfig::lowPickRateThreshold() const {
      return m_settings.value("Settings/LowPickRateThreshold", m_defaultLowPrThreshold).toDouble();
@@ -126,6 +151,74 @@ int AppConfig::mctsUpdateIntervalIters() const {
      return m_settings.value("Settings/MctsUpdateIntervalIters", m_defaultMctsUpdateIntervalIters).toInt();
 }
 
+int AppConfig::mctsThreads() const {
+    return std::max(0, m_settings.value("Settings/MctsThreads", m_defaultMctsThreads).toInt());
+}
+
+double AppConfig::mctsVirtualLoss() const {
+    double loss = m_settings.value("Settings/MctsVirtualLoss", m_defaultMctsVirtualLoss).toDouble();
+    return std::max(0.0, loss);
+}
+
+MctsParallelMode AppConfig::mctsParallelMode() const {
+    QString mode = m_settings.value("Settings/MctsParallelMode", m_defaultMctsParallelMode).toString().trimmed();
+    if (mode.compare("RootParallel", Qt::CaseInsensitive) == 0) {
+        return MctsParallelMode::RootParallel;
+    }
+    if (mode.compare("SharedTree", Qt::CaseInsensitive) != 0) {
+        qWarning() << "Unknown MctsParallelMode" << mode << "in config, using SharedTree.";
+    }
+    return MctsParallelMode::SharedTree;
+}
+
+QString mctsLeafEvaluationName(MctsLeafEvaluation mode) {
+    switch (mode) {
+    case MctsLeafEvaluation::FastRollout: return QStringLiteral("FastRollout");
+    case MctsLeafEvaluation::Static: return QStringLiteral("Static");
+    default: return QStringLiteral("HeuristicRollout");
+    }
+}
+
+MctsLeafEvaluation AppConfig::parseMctsLeafEvaluation(const QString& name) {
+    const QString mode = name.trimmed();
+    for (MctsLeafEvaluation candidate : {MctsLeafEvaluation::HeuristicRollout, MctsLeafEvaluation::FastRollout, MctsLeafEvaluation::Static}) {
+        if (mode.compare(mctsLeafEvaluationName(candidate), Qt::CaseInsensitive) == 0) {
+            return candidate;
+        }
+    }
+    qWarning() << "Unknown MctsLeafEvaluation" << mode << "in config, using HeuristicRollout.";
+    return MctsLeafEvaluation::HeuristicRollout;
+}
+
+MctsLeafEvaluation AppConfig::mctsLeafEvaluation() const {
+    // Return the 'current' mode loaded/defaulted/set
+    return m_currentMctsLeafEvaluation;
+}
+
+MctsSelection AppConfig::mctsSelection() const {
+    QString mode = m_settings.value("Settings/MctsSelection", m_defaultMctsSelection).toString().trimmed();
+    if (mode.compare("PUCT", Qt::CaseInsensitive) == 0) {
+        return MctsSelection::PUCT;
+    }
+    if (mode.compare("UCT", Qt::CaseInsensitive) != 0) {
+        qWarning() << "Unknown MctsSelection" << mode << "in config, using UCT.";
+    }
+    return MctsSelection::UCT;
+}
+
+double AppConfig::mctsWidening() const {
+    return std::max(0.0, m_settings.value("Settings/MctsWidening", m_defaultMctsWidening).toDouble());
+}
+
+int AppConfig::mctsMemoryBudgetMB() const {
+    return std::max(0, m_settings.value("Settings/MctsMemoryBudgetMB", m_defaultMctsMemoryBudgetMB).toInt());
+}
+
+int AppConfig::statsMemoryBudgetMB() const {
+    int budget = m_settings.value("Settings/StatsMemoryBudgetMB", m_defaultStatsMemoryBudgetMB).toInt();
+    return std::max(0, budget); // Negative makes no sense, treat as unlimited
+}
+
 // --- Setters ---
 // void AppConfig::setHeuristicWeights(const HeuristicWeights& weights) {
 //     // This is now unused if UI is removed
@@ -139,9 +232,57 @@ void AppConfig::setMctsTimeLimit(double limit) {
         qWarning() << "Attempted to set invalid MCTS time limit:" << limit << ". Using default:" << m_defaultMctsTimeLimit;
         m_currentMctsTimeLimit = m_defaultMctsTimeLimit; // Reset to default if invalid
     }
+    ++m_version;
      // save() needs to be called explicitly later (e.g., on window close)
 }
 
+void AppConfig::setRankFloor(int rank) {
+    m_currentRankFloor = std::max(0, rank);
+    ++m_version;
+}
+
+void AppConfig::setMctsLeafEvaluation(MctsLeafEvaluation mode) {
+    m_currentMctsLeafEvaluation = mode;
+    ++m_version;
+}
+
+
+// --- Snapshot ---
+ConfigSnapshot AppConfig::snapshot() const {
+    ConfigSnapshot snap;
+    snap.version = m_version;
+    snap.smoothingK = smoothingK();
+    snap.minRank = minRank();
+    snap.maxRankConsidered = maxRankConsidered();
+    snap.rankWeightScaleDivisor = rankWeightScaleDivisor();
+    snap.rankFloor = rankFloor();
+    snap.rankCeiling = rankCeiling();
+    snap.lowPickRateThreshold = lowPickRateThreshold();
+    snap.lowConfidenceWinRateTarget = lowConfidenceWinRateTarget();
+    snap.heuristicWeights = heuristicWeights();
+    snap.mctsTimeLimit = mctsTimeLimit();
+    snap.mctsExplorationParam = mctsExplorationParam();
+    snap.mctsResultCount = mctsResultCount();
+    snap.mctsUpdateIntervalIters = mctsUpdateIntervalIters();
+    snap.mctsThreads = mctsThreads();
+    snap.mctsVirtualLoss = mctsVirtualLoss();
+    snap.mctsParallelMode = mctsParallelMode();
+    snap.mctsLeafEvaluation = mctsLeafEvaluation();
+    snap.mctsSelection = mctsSelection();
+    snap.mctsWidening = mctsWidening();
+    snap.mctsMemoryBudgetMB = mctsMemoryBudgetMB();
+    snap.statsMemoryBudgetMB = statsMemoryBudgetMB();
+
+    // One entry per rank in [minRank, maxRankConsidered]; at least one so a
+    // misconfigured range (min > max) still maps everything to minRank
+    int rankCount = std::max(1, snap.maxRankConsidered - snap.minRank + 1);
+    snap.rankWeights.resize(rankCount);
+    for (int i = 0; i < rankCount; ++i) {
+        snap.rankWeights[i] = getRankWeight(snap.minRank + i);
+    }
+    return snap;
+}
+
 
 // --- Helper ---
 double AppConfig::getRankWeight(int rank) const {
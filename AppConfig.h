@@ -5,8 +5,62 @@
 #include <QSettings>
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <algorithm> // For std::max, std::min
+#include <QVector>
 #include "DataStructures.h" // For HeuristicWeights
 
+// How MCTS workers share the search: one tree they all grow together, or a
+// private tree each whose root statistics are added up when reporting
+enum class MctsParallelMode { SharedTree, RootParallel };
+
+// How MCTS scores a new leaf: play the draft out picking the heuristic's best
+// brawler each time, play it out with a cheap sampled policy, or score the
+// picks made so far directly
+enum class MctsLeafEvaluation { HeuristicRollout, FastRollout, Static };
+QString mctsLeafEvaluationName(MctsLeafEvaluation mode); // As written in the config
+
+// MCTS child selection: plain UCT over every legal pick in ID order, or PUCT
+// with heuristic priors and progressive widening (best-scored picks first)
+enum class MctsSelection { UCT, PUCT };
+
+// Plain-value copy of the config taken once and handed to StatsBuilder and
+// MCTSManager, so hot paths (and worker threads) never touch QSettings.
+// 'version' matches AppConfig::version() at the time the snapshot was taken.
+struct ConfigSnapshot {
+    quint64 version = 0;
+
+    double smoothingK = 2.0;
+    int minRank = 10;
+    int maxRankConsidered = 22;
+    double rankWeightScaleDivisor = 3.0;
+    int rankFloor = 0;   // Stats only count players at or above this rank (0 = no floor)
+    int rankCeiling = 0; // ... and at or below this one (0 = no ceiling)
+    double lowPickRateThreshold = 0.03;
+    double lowConfidenceWinRateTarget = 0.0;
+    HeuristicWeights heuristicWeights;
+    double mctsTimeLimit = 7.0;
+    double mctsExplorationParam = 1.414;
+    int mctsResultCount = 10;
+    int mctsUpdateIntervalIters = 250;
+    int mctsThreads = 0;          // Search workers (0 = one per core)
+    double mctsVirtualLoss = 1.0; // Losses a worker's pending visit counts as for the others (0 = off)
+    MctsParallelMode mctsParallelMode = MctsParallelMode::SharedTree;
+    MctsLeafEvaluation mctsLeafEvaluation = MctsLeafEvaluation::HeuristicRollout;
+    MctsSelection mctsSelection = MctsSelection::UCT;
+    double mctsWidening = 2.0; // PUCT: a node may have ceil(w * sqrt(visits)) children (0 = all of them)
+    int mctsMemoryBudgetMB = 1024; // Search tree nodes/edges of one search, all workers (0 = no cap)
+    int statsMemoryBudgetMB = 64; // 0 = keep every loaded map/mode resident
+
+    // Rank weight lookup, index = clamped rank - minRank
+    QVector<double> rankWeights;
+
+    double getRankWeight(int rank) const {
+        int clampedRank = std::max(minRank, std::min(rank, maxRankConsidered));
+        int index = clampedRank - minRank;
+        return (index < rankWeights.size()) ? rankWeights[index] : 0.1;
+    }
+};
+
 class AppConfig {
 public:
     // Constructor now takes the full path to the config file
@@ -20,6 +74,8 @@ public:
     int minRank() const;
     int maxRankConsidered() const;
     double rankWeightScaleDivisor() const;
+    int rankFloor() const;
+    int rankCeiling() const;
     double lowPickRateThreshold() const;
     double lowConfidenceWinRateTarget() const;
     HeuristicWeights heuristicWeights() const; // Reads from m_currentWeights
@@ -27,17 +83,33 @@ public:
     double mctsExplorationParam() const;
     int mctsResultCount() const;
     int mctsUpdateIntervalIters() const;
+    int mctsThreads() const;
+    double mctsVirtualLoss() const;
+    MctsParallelMode mctsParallelMode() const; // "SharedTree" or "RootParallel"
+    MctsLeafEvaluation mctsLeafEvaluation() const; // "HeuristicRollout", "FastRollout" or "Static"
+    MctsSelection mctsSelection() const; // "UCT" or "PUCT"
+    double mctsWidening() const;
+    int mctsMemoryBudgetMB() const;
+    int statsMemoryBudgetMB() const;
 
     // Setters primarily for GUI updates -> save
     // setHeuristicWeights is now only used internally if needed, UI doesn't set it
     // void setHeuristicWeights(const HeuristicWeights& weights);
     void setMctsTimeLimit(double limit);
+    void setRankFloor(int rank);
+    void setMctsLeafEvaluation(MctsLeafEvaluation mode); // mcts_bench runs each mode in turn
 
     // Helper for rank weighting
     double getRankWeight(int rank) const;
 
+    // Bumped whenever a value changes (load, setters)
+    quint64 version() const { return m_version; }
+    // Reads everything from QSettings once; safe to copy into other threads
+    ConfigSnapshot snapshot() const;
+
 private:
     void loadDefaults();
+    static MctsLeafEvaluation parseMctsLeafEvaluation(const QString& name);
 
     QSettings m_settings; // Will be initialized with the path
 
@@ -46,6 +118,8 @@ private:
     int m_defaultMinRank = 10;
     int m_defaultMaxRankConsidered = 22;
     double m_defaultRankWeightScaleDivisor = 3.0;
+    int m_defaultRankFloor = 0;
+    int m_defaultRankCeiling = 0;
     double m_defaultLowPrThreshold = 0.03;
     double m_defaultLowConfidenceWrTarget = 0.0;
     HeuristicWeights m_defaultWeights = {0.5, 0.3, 0.4, 0.2};
@@ -53,10 +127,22 @@ private:
     double m_defaultMctsExplorationParam = 1.414;
     int m_defaultMctsResultCount = 10;
     int m_defaultMctsUpdateIntervalIters = 250;
+    int m_defaultMctsThreads = 0;
+    double m_defaultMctsVirtualLoss = 1.0;
+    QString m_defaultMctsParallelMode = "SharedTree";
+    QString m_defaultMctsLeafEvaluation = "HeuristicRollout";
+    QString m_defaultMctsSelection = "UCT";
+    double m_defaultMctsWidening = 2.0;
+    int m_defaultMctsMemoryBudgetMB = 1024;
+    int m_defaultStatsMemoryBudgetMB = 64;
 
     // Current values (loaded from settings, potentially updated by setters)
     HeuristicWeights m_currentWeights;
     double m_currentMctsTimeLimit;
+    int m_currentRankFloor;
+    MctsLeafEvaluation m_currentMctsLeafEvaluation;
+
+    quint64 m_version = 0;
 
 };
 
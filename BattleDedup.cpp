@@ -0,0 +1,107 @@
+#include "BattleDedup.h"
+#include <QMutexLocker>
+#include <algorithm> // For std::sort
+
+namespace {
+
+    // FNV-1a over the UTF-16 code units, with a separator so field boundaries count
+    void hashField(quint64& h, const QString& field) {
+        constexpr quint64 FNV_PRIME = 0x100000001b3ULL;
+        for (QChar c : field) {
+            h = (h ^ c.unicode()) * FNV_PRIME;
+        }
+        h = (h ^ 0xFFFFu) * FNV_PRIME; // 0xFFFF is a noncharacter, never part of a field
+    }
+
+    // Spreads the bits so both the shard (top bits) and slot (low bits) are uniform
+    quint64 mix(quint64 h) {
+        h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+} // namespace
+
+
+BattleDedup::BattleDedup() {
+    for (Shard& shard : m_shards) {
+        shard.table.fill(0, INITIAL_SLOTS);
+    }
+}
+
+quint64 BattleDedup::fingerprint(const BattleRecord& record) {
+    if (record.battleTime.isEmpty()) return 0;
+
+    // Tags sorted, so every player's copy of the battle gives the same key
+    QVector<QString> tags = record.tags[0];
+    tags += record.tags[1];
+    std::sort(tags.begin(), tags.end());
+
+    quint64 h = 0xcbf29ce484222325ULL; // FNV offset basis
+    hashField(h, record.battleTime);
+    hashField(h, record.map);
+    hashField(h, record.mode);
+    for (const QString& tag : tags) hashField(h, tag);
+    h = mix(h);
+    return h ? h : 1;
+}
+
+bool BattleDedup::insert(quint64 fingerprint) {
+    if (fingerprint == 0) return true; // Can't tell copies apart, keep it
+    Shard& shard = m_shards[fingerprint >> (64 - SHARD_BITS)];
+    QMutexLocker locker(&shard.mutex);
+    return insertLocked(shard, fingerprint);
+}
+
+void BattleDedup::insertAll(const QVector<quint64>& fingerprints) {
+    for (quint64 fingerprint : fingerprints) {
+        insert(fingerprint);
+    }
+}
+
+bool BattleDedup::insertLocked(Shard& shard, quint64 fingerprint) {
+    if ((shard.count + 1) * 4 > shard.table.size() * 3) grow(shard); // Keep load <= 3/4
+
+    const qsizetype mask = shard.table.size() - 1;
+    for (qsizetype i = static_cast<qsizetype>(fingerprint) & mask; ; i = (i + 1) & mask) {
+        quint64& slot = shard.table[i];
+        if (slot == fingerprint) return false;
+        if (slot == 0) {
+            slot = fingerprint;
+            shard.count++;
+            return true;
+        }
+    }
+}
+
+void BattleDedup::grow(Shard& shard) {
+    QVector<quint64> old = std::move(shard.table);
+    shard.table = QVector<quint64>(old.size() * 2, 0);
+    shard.count = 0;
+    for (quint64 fingerprint : old) {
+        if (fingerprint != 0) insertLocked(shard, fingerprint);
+    }
+}
+
+qsizetype BattleDedup::size() const {
+    qsizetype total = 0;
+    for (const Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        total += shard.count;
+    }
+    return total;
+}
+
+QVector<quint64> BattleDedup::sortedValues() const {
+    QVector<quint64> values;
+    values.reserve(size());
+    for (const Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        for (quint64 fingerprint : shard.table) {
+            if (fingerprint != 0) values.append(fingerprint);
+        }
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
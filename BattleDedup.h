@@ -0,0 +1,52 @@
+#ifndef BATTLEDEDUP_H
+#define BATTLEDEDUP_H
+
+#include <QVector>
+#include <QMutex>
+#include "DataStructures.h" // For BattleRecord
+
+// The scraper logs a battle once per queried player that took part, so the
+// same game can appear several times. Every copy describes the same teams and
+// outcome (DataLoader normalizes the result to winners/losers). DataLoader
+// inserts in file order, so the copy at the lowest offset is the one kept and
+// games.bin rows don't depend on how the chunks were scheduled.
+//
+// Exact set of 64-bit battle fingerprints (battle time, map, mode and the
+// sorted player tags). Split into shards with their own lock and open
+// addressing table (8 bytes per slot, no per-entry allocation), so the ingest
+// workers can insert concurrently. No Bloom filter: a false positive would
+// silently drop a real game.
+class BattleDedup {
+public:
+    BattleDedup();
+    BattleDedup(const BattleDedup&) = delete;
+    BattleDedup& operator=(const BattleDedup&) = delete;
+
+    // 0 if the record has no battle time (such lines are never treated as duplicates)
+    static quint64 fingerprint(const BattleRecord& record);
+
+    // True if the fingerprint wasn't in the set yet. Thread safe.
+    bool insert(quint64 fingerprint);
+    // Seeds the set, e.g. with the fingerprints stored in the stats pack
+    void insertAll(const QVector<quint64>& fingerprints);
+
+    qsizetype size() const;
+    QVector<quint64> sortedValues() const;
+
+private:
+    static constexpr int SHARD_BITS = 6;
+    static constexpr int SHARD_COUNT = 1 << SHARD_BITS;
+    static constexpr qsizetype INITIAL_SLOTS = 1024; // Per shard, power of two
+
+    struct Shard {
+        mutable QMutex mutex;
+        QVector<quint64> table; // 0 = empty (fingerprint() never returns 0 for a real battle)
+        qsizetype count = 0;
+    };
+    static bool insertLocked(Shard& shard, quint64 fingerprint);
+    static void grow(Shard& shard);
+
+    Shard m_shards[SHARD_COUNT];
+};
+
+#endif // BATTLEDEDUP_H
@@ -0,0 +1,326 @@
+#include "BattleLineParser.h"
+#include <QString>
+#include <cstring>
+
+namespace {
+
+    constexpr int MAX_DEPTH = 64; // Deeper nesting goes to the Qt parser
+
+    // Byte cursor over one line. Every method returns false for anything it
+    // doesn't handle, which sends the whole line to the fallback path.
+    class Scanner {
+    public:
+        Scanner(const char* data, qint64 size) : m_p(data), m_end(data + size) {}
+
+        void skipWhitespace() {
+            while (m_p < m_end && (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r')) ++m_p;
+        }
+        bool atEnd() { skipWhitespace(); return m_p == m_end; }
+        bool consume(char c) {
+            skipWhitespace();
+            if (m_p < m_end && *m_p == c) { ++m_p; return true; }
+            return false;
+        }
+
+        // Validates a string; [begin, end) is the raw content between the quotes.
+        // 'plain' is false if it has escapes or non-ASCII bytes.
+        bool scanString(const char*& begin, const char*& end, bool& plain) {
+            if (!consume('"')) return false;
+            begin = m_p;
+            plain = true;
+            while (m_p < m_end) {
+                unsigned char c = static_cast<unsigned char>(*m_p);
+                if (c == '"') {
+                    end = m_p++;
+                    return true;
+                }
+                if (c < 0x20) return false; // Raw control character
+                if (c == '\\') {
+                    plain = false;
+                    if (!skipEscape()) return false;
+                } else if (c >= 0x80) {
+                    plain = false;
+                    if (!skipUtf8Sequence()) return false;
+                } else {
+                    ++m_p;
+                }
+            }
+            return false; // Unterminated
+        }
+
+        // Only plain ASCII strings are kept; anything needing decoding falls back
+        bool readPlainString(QString& out) {
+            const char* begin;
+            const char* end;
+            bool plain;
+            if (!scanString(begin, end, plain) || !plain) return false;
+            out = QString::fromLatin1(begin, static_cast<qsizetype>(end - begin));
+            return true;
+        }
+
+        // Positive integer literal (what QJsonValue::toInt() keeps as a valid rank)
+        bool readPositiveInt(int& out) {
+            skipWhitespace();
+            const char* start = m_p;
+            qint64 value = 0;
+            while (m_p < m_end && *m_p >= '0' && *m_p <= '9' && m_p - start < 9) {
+                value = value * 10 + (*m_p - '0');
+                ++m_p;
+            }
+            if (m_p == start || (*start == '0' && m_p - start > 1) || value <= 0) return false;
+            if (m_p < m_end && ((*m_p >= '0' && *m_p <= '9') || *m_p == '.' || *m_p == 'e' || *m_p == 'E')) return false;
+            out = static_cast<int>(value);
+            return true;
+        }
+
+        bool skipValue(int depth) {
+            if (depth > MAX_DEPTH) return false;
+            skipWhitespace();
+            if (m_p >= m_end) return false;
+            switch (*m_p) {
+            case '{': return forEachMember(depth, [this, depth](const char*, qint64) { return skipValue(depth + 1); });
+            case '[': return forEachElement(depth, [this, depth](int) { return skipValue(depth + 1); });
+            case '"': {
+                const char* begin;
+                const char* end;
+                bool plain;
+                return scanString(begin, end, plain);
+            }
+            case 't': return skipLiteral("true");
+            case 'f': return skipLiteral("false");
+            case 'n': return skipLiteral("null");
+            default: return skipNumber();
+            }
+        }
+
+        // Calls onMember(key, keyLength) for each member; it must consume the value
+        template <typename F>
+        bool forEachMember(int depth, F onMember) {
+            if (depth > MAX_DEPTH || !consume('{')) return false;
+            if (consume('}')) return true;
+            while (true) {
+                const char* key;
+                const char* keyEnd;
+                bool plain;
+                // An escaped key could still spell a field we need, let Qt decode it
+                if (!scanString(key, keyEnd, plain) || !plain || !consume(':')) return false;
+                if (!onMember(key, keyEnd - key)) return false;
+                if (consume(',')) continue;
+                return consume('}');
+            }
+        }
+
+        // Calls onElement(index) for each element; it must consume the value
+        template <typename F>
+        bool forEachElement(int depth, F onElement) {
+            if (depth > MAX_DEPTH || !consume('[')) return false;
+            if (consume(']')) return true;
+            for (int index = 0; ; ++index) {
+                if (!onElement(index)) return false;
+                if (consume(',')) continue;
+                return consume(']');
+            }
+        }
+
+    private:
+        bool skipLiteral(const char* word) {
+            const qint64 length = static_cast<qint64>(std::strlen(word));
+            if (m_end - m_p < length || std::memcmp(m_p, word, static_cast<size_t>(length)) != 0) return false;
+            m_p += length;
+            return true;
+        }
+
+        // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+        bool skipNumber() {
+            auto digits = [this]() {
+                const char* start = m_p;
+                while (m_p < m_end && *m_p >= '0' && *m_p <= '9') ++m_p;
+                return m_p > start;
+            };
+            if (m_p < m_end && *m_p == '-') ++m_p;
+            if (m_p < m_end && *m_p == '0') {
+                ++m_p;
+            } else if (!digits()) {
+                return false;
+            }
+            if (m_p < m_end && *m_p == '.') {
+                ++m_p;
+                if (!digits()) return false;
+            }
+            if (m_p < m_end && (*m_p == 'e' || *m_p == 'E')) {
+                ++m_p;
+                if (m_p < m_end && (*m_p == '+' || *m_p == '-')) ++m_p;
+                if (!digits()) return false;
+            }
+            return true;
+        }
+
+        bool skipEscape() {
+            if (m_end - m_p < 2) return false;
+            char e = m_p[1];
+            if (e == 'u') {
+                if (m_end - m_p < 6) return false;
+                unsigned code = 0;
+                for (int i = 2; i < 6; ++i) {
+                    char h = m_p[i];
+                    unsigned digit;
+                    if (h >= '0' && h <= '9') digit = h - '0';
+                    else if (h >= 'a' && h <= 'f') digit = h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F') digit = h - 'A' + 10;
+                    else return false;
+                    code = code * 16 + digit;
+                }
+                if (code >= 0xD800 && code <= 0xDFFF) return false; // Surrogates: leave pairing rules to Qt
+                m_p += 6;
+                return true;
+            }
+            if (e == '"' || e == '\\' || e == '/' || e == 'b' || e == 'f' || e == 'n' || e == 'r' || e == 't') {
+                m_p += 2;
+                return true;
+            }
+            return false;
+        }
+
+        // One well-formed UTF-8 sequence (no overlongs, surrogates or noncharacters)
+        bool skipUtf8Sequence() {
+            const unsigned char* s = reinterpret_cast<const unsigned char*>(m_p);
+            const qint64 available = m_end - m_p;
+            auto cont = [s](int i) { return (s[i] & 0xC0) == 0x80; };
+            int length;
+            unsigned char c = s[0];
+            if (c >= 0xC2 && c <= 0xDF) length = 2;
+            else if (c >= 0xE0 && c <= 0xEF) length = 3;
+            else if (c >= 0xF0 && c <= 0xF4) length = 4;
+            else return false;
+            if (available < length) return false;
+            for (int i = 1; i < length; ++i) {
+                if (!cont(i)) return false;
+            }
+            if (c == 0xE0 && s[1] < 0xA0) return false; // Overlong
+            if (c == 0xED && s[1] > 0x9F) return false; // Surrogate
+            if (c == 0xEF && s[1] == 0xBF && s[2] >= 0xBE) return false; // U+FFFE/FFFF
+            if (c == 0xEF && s[1] == 0xB7 && s[2] >= 0x90 && s[2] <= 0xAF) return false; // U+FDD0..FDEF
+            if (c == 0xF0 && s[1] < 0x90) return false; // Overlong
+            if (c == 0xF4 && s[1] > 0x8F) return false; // > U+10FFFF
+            m_p += length;
+            return true;
+        }
+
+        const char* m_p;
+        const char* m_end;
+    };
+
+    bool keyIs(const char* key, qint64 length, const char* name) {
+        return static_cast<size_t>(length) == std::strlen(name) && std::memcmp(key, name, static_cast<size_t>(length)) == 0;
+    }
+
+    // One team: exactly 3 players, each with a tag and brawler name/rank
+    bool readTeam(Scanner& s, int depth, QVector<PlayerData>& players, QVector<QString>& tags) {
+        bool ok = s.forEachElement(depth, [&](int index) {
+            if (index >= 3) return false;
+            PlayerData player;
+            QString tag;
+            bool haveTag = false, haveName = false, haveRank = false, haveBrawler = false;
+            bool memberOk = s.forEachMember(depth + 1, [&](const char* key, qint64 length) {
+                if (keyIs(key, length, "tag")) {
+                    if (haveTag) return false;
+                    haveTag = true;
+                    return s.readPlainString(tag);
+                }
+                if (keyIs(key, length, "brawler")) {
+                    if (haveBrawler) return false;
+                    haveBrawler = true;
+                    return s.forEachMember(depth + 2, [&](const char* bKey, qint64 bLength) {
+                        if (keyIs(bKey, bLength, "name")) {
+                            if (haveName) return false;
+                            haveName = true;
+                            return s.readPlainString(player.brawlerName);
+                        }
+                        if (keyIs(bKey, bLength, "rank")) {
+                            if (haveRank) return false;
+                            haveRank = true;
+                            return s.readPositiveInt(player.rank);
+                        }
+                        return s.skipValue(depth + 3);
+                    });
+                }
+                return s.skipValue(depth + 2);
+            });
+            if (!memberOk || !haveTag || !haveName || !haveRank || player.brawlerName.isEmpty()) return false;
+            players.append(player);
+            tags.append(tag);
+            return true;
+        });
+        return ok && players.size() == 3;
+    }
+
+} // namespace
+
+
+namespace BattleLineParser {
+
+    bool parse(const char* data, qint64 size, BattleRecord& out) {
+        Scanner s(data, size);
+        bool haveEvent = false, haveBattle = false, haveTag = false;
+        bool haveMode = false, haveMap = false, haveResult = false, haveTeams = false, haveTime = false;
+        int teamCount = 0;
+
+        bool ok = s.forEachMember(1, [&](const char* key, qint64 length) {
+            if (keyIs(key, length, "event")) {
+                if (haveEvent) return false;
+                haveEvent = true;
+                return s.forEachMember(2, [&](const char* eKey, qint64 eLength) {
+                    if (keyIs(eKey, eLength, "mode")) {
+                        if (haveMode) return false;
+                        haveMode = true;
+                        return s.readPlainString(out.mode);
+                    }
+                    if (keyIs(eKey, eLength, "map")) {
+                        if (haveMap) return false;
+                        haveMap = true;
+                        return s.readPlainString(out.map);
+                    }
+                    return s.skipValue(3);
+                });
+            }
+            if (keyIs(key, length, "battle")) {
+                if (haveBattle) return false;
+                haveBattle = true;
+                return s.forEachMember(2, [&](const char* bKey, qint64 bLength) {
+                    if (keyIs(bKey, bLength, "result")) {
+                        if (haveResult) return false;
+                        haveResult = true;
+                        return s.readPlainString(out.result);
+                    }
+                    if (keyIs(bKey, bLength, "teams")) {
+                        if (haveTeams) return false;
+                        haveTeams = true;
+                        return s.forEachElement(3, [&](int index) {
+                            teamCount = index + 1;
+                            if (index < 2) return readTeam(s, 4, out.teams[index], out.tags[index]);
+                            return s.skipValue(4); // Only the first two teams are used
+                        });
+                    }
+                    return s.skipValue(3);
+                });
+            }
+            if (keyIs(key, length, "battleTime")) {
+                if (haveTime) return false;
+                haveTime = true;
+                return s.readPlainString(out.battleTime);
+            }
+            if (keyIs(key, length, "queried_player_tag")) {
+                if (haveTag) return false;
+                haveTag = true;
+                return s.readPlainString(out.queriedPlayerTag);
+            }
+            return s.skipValue(2);
+        });
+
+        // Anything the fast path can't vouch for is re-checked (and counted) by the Qt path
+        return ok && s.atEnd() &&
+               haveEvent && haveBattle && haveTag && haveTeams && teamCount >= 2 &&
+               !out.mode.isEmpty() && !out.map.isEmpty() && !out.result.isEmpty();
+    }
+
+} // namespace BattleLineParser
@@ -0,0 +1,25 @@
+#ifndef BATTLELINEPARSER_H
+#define BATTLELINEPARSER_H
+
+#include <QtGlobal>
+#include "DataStructures.h" // For BattleRecord
+
+// Single-pass scanner for one line of high_level_ranked_games.jsonl. Walks the
+// raw UTF-8 bytes once, validating the JSON as it goes, and only builds
+// QStrings for the handful of fields ingest uses (event.mode/map,
+// battle.result/teams, battleTime, queried_player_tag); everything else is
+// skipped in place.
+//
+// It only accepts the common, clean case. Anything unusual (escapes in a field
+// we keep, duplicate keys, non-integer ranks, wrong types, malformed JSON...)
+// returns false and the caller falls back to the QJsonDocument path, which
+// does the full checks and skip accounting.
+namespace BattleLineParser {
+
+    // True if 'data' is a valid JSON object whose fields pass the structural
+    // checks in DataLoader::processGame; 'out' is filled in that case.
+    bool parse(const char* data, qint64 size, BattleRecord& out);
+
+} // namespace BattleLineParser
+
+#endif // BATTLELINEPARSER_H
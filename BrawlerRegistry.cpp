@@ -0,0 +1,64 @@
+#include "BrawlerRegistry.h"
+#include <QDebug>
+#include <algorithm> // For std::sort
+
+BrawlerRegistry::BrawlerRegistry(const QSet<QString>& brawlerNames) {
+    m_names = QVector<QString>(brawlerNames.begin(), brawlerNames.end());
+    std::sort(m_names.begin(), m_names.end()); // Alphabetical IDs keep results deterministic
+
+    if (m_names.size() >= INVALID_BRAWLER_ID) {
+        qCritical() << "Too many brawlers for BrawlerId:" << m_names.size();
+        m_names.resize(INVALID_BRAWLER_ID - 1);
+    }
+
+    m_ids.reserve(m_names.size());
+    for (int i = 0; i < m_names.size(); ++i) {
+        m_ids.insert(m_names[i], static_cast<BrawlerId>(i));
+    }
+}
+
+BrawlerRegistry::BrawlerRegistry(const QVector<QString>& orderedNames)
+    : m_names(orderedNames)
+{
+    if (m_names.size() >= INVALID_BRAWLER_ID) {
+        qCritical() << "Too many brawlers for BrawlerId:" << m_names.size();
+        m_names.resize(INVALID_BRAWLER_ID - 1);
+    }
+
+    m_ids.reserve(m_names.size());
+    for (int i = 0; i < m_names.size(); ++i) {
+        m_ids.insert(m_names[i], static_cast<BrawlerId>(i));
+    }
+}
+
+BrawlerId BrawlerRegistry::add(const QString& name) {
+    auto it = m_ids.constFind(name);
+    if (it != m_ids.constEnd()) return it.value();
+    if (m_names.size() >= INVALID_BRAWLER_ID - 1) {
+        qCritical() << "Too many brawlers for BrawlerId, ignoring:" << name;
+        return INVALID_BRAWLER_ID;
+    }
+    BrawlerId id = static_cast<BrawlerId>(m_names.size());
+    m_names.append(name);
+    m_ids.insert(name, id);
+    return id;
+}
+
+QVector<BrawlerId> BrawlerRegistry::idsOf(const QVector<QString>& names) const {
+    QVector<BrawlerId> ids;
+    ids.reserve(names.size());
+    for (const QString& name : names) {
+        BrawlerId id = idOf(name);
+        if (id != INVALID_BRAWLER_ID) ids.append(id);
+    }
+    return ids;
+}
+
+QVector<QString> BrawlerRegistry::namesOf(const QVector<BrawlerId>& ids) const {
+    QVector<QString> names;
+    names.reserve(ids.size());
+    for (BrawlerId id : ids) {
+        if (isValid(id)) names.append(m_names[id]);
+    }
+    return names;
+}
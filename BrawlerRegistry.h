@@ -0,0 +1,63 @@
+#ifndef BRAWLERREGISTRY_H
+#define BRAWLERREGISTRY_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <limits>
+
+// Compact integer handle for a brawler name. IDs are dense (0..size()-1) and
+// assigned in alphabetical order, so iterating IDs ascending matches the old
+// sorted-name iteration order.
+using BrawlerId = quint16;
+constexpr BrawlerId INVALID_BRAWLER_ID = std::numeric_limits<BrawlerId>::max();
+
+// Interned name table built once at load time from CacheData::allBrawlers.
+// Read-only after construction, so it is safe to share between threads.
+// (StatsBuilder also grows one with add() while streaming games in, then
+// swaps it for a sorted one before anything else sees it.)
+class BrawlerRegistry {
+public:
+    BrawlerRegistry() = default;
+    explicit BrawlerRegistry(const QSet<QString>& brawlerNames);
+    // Keeps the given order as the IDs (e.g. names read back from a stats pack)
+    explicit BrawlerRegistry(const QVector<QString>& orderedNames);
+
+    int size() const { return m_names.size(); }
+    bool isEmpty() const { return m_names.isEmpty(); }
+
+    // Returns INVALID_BRAWLER_ID for unknown names
+    BrawlerId idOf(const QString& name) const { return m_ids.value(name, INVALID_BRAWLER_ID); }
+    const QString& nameOf(BrawlerId id) const { return m_names.at(id); }
+    bool isValid(BrawlerId id) const { return id < m_names.size(); }
+
+    // Returns the existing ID, or appends the name with the next free ID
+    // (INVALID_BRAWLER_ID if the table is full). Not thread safe.
+    BrawlerId add(const QString& name);
+
+    // Converts a list of names, skipping unknown ones
+    QVector<BrawlerId> idsOf(const QVector<QString>& names) const;
+    QVector<QString> namesOf(const QVector<BrawlerId>& ids) const;
+
+    const QVector<QString>& names() const { return m_names; }
+
+private:
+    QVector<QString> m_names;          // Index = BrawlerId
+    QHash<QString, BrawlerId> m_ids;   // Name -> BrawlerId
+};
+
+// Helpers for packing synergy/counter pair keys into a single integer
+inline quint32 sortedPairKey(BrawlerId b1, BrawlerId b2) {
+    return (b1 < b2) ? (static_cast<quint32>(b1) << 16) | b2
+                     : (static_cast<quint32>(b2) << 16) | b1;
+}
+
+inline quint32 counterPairKey(BrawlerId bUs, BrawlerId bThem) {
+    return (static_cast<quint32>(bUs) << 16) | bThem;
+}
+
+inline BrawlerId pairKeyFirst(quint32 key) { return static_cast<BrawlerId>(key >> 16); }
+inline BrawlerId pairKeySecond(quint32 key) { return static_cast<BrawlerId>(key & 0xFFFF); }
+
+#endif // BRAWLERREGISTRY_H
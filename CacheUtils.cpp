@@ -3,9 +3,15 @@
 #include <QDataStream>
 #include <QDebug>
 #include <QDir> // To ensure directory exists
+#include <algorithm> // For std::set_union
+#include <iterator>  // For std::back_inserter
 
 namespace CacheUtils {
 
+    // Version 2 added CacheMetadata::ingestedOffsets; version 1 files still load
+    const qint16 CACHE_VERSION = 2;
+    const qint16 MIN_CACHE_VERSION = 1;
+
     bool saveCache(const QString& filepath, const CacheData& data) {
         QFileInfo fileInfo(filepath);
         QDir dir = fileInfo.dir();
@@ -27,7 +33,7 @@ namespace CacheUtils {
         // Optional: Add a version number for future compatibility
         out.setVersion(QDataStream::Qt_6_0); // Or your target Qt version
         quint32 magicNumber = 0xACEDBABE; // Simple magic number
-        qint16 version = 1;
+        qint16 version = CACHE_VERSION;
         out << magicNumber;
         out << version;
 
@@ -73,8 +79,8 @@ namespace CacheUtils {
             return std::nullopt;
         }
         in >> version;
-         if (in.status() != QDataStream::Ok || version != 1) { // Check version compatibility
-            qWarning() << "Cache file version mismatch (expected 1, got" << version << "):" << filepath;
+         if (in.status() != QDataStream::Ok || version < MIN_CACHE_VERSION || version > CACHE_VERSION) { // Check version compatibility
+            qWarning() << "Cache file version mismatch (expected" << MIN_CACHE_VERSION << "to" << CACHE_VERSION << ", got" << version << "):" << filepath;
             return std::nullopt;
         }
 
@@ -100,4 +106,46 @@ namespace CacheUtils {
         return loadedData;
     }
 
+
+    void mergeCacheData(CacheData& into, const CacheData& delta) {
+        auto mergeEntries = [](QHash<QString, BrawlerStatsData>& target, const QHash<QString, BrawlerStatsData>& source) {
+            for (auto it = source.constBegin(); it != source.constEnd(); ++it) {
+                BrawlerStatsData& t = target[it.key()];
+                t.wins += it.value().wins;
+                t.plays += it.value().plays;
+            }
+        };
+
+        for (auto mapIt = delta.stats.constBegin(); mapIt != delta.stats.constEnd(); ++mapIt) {
+            for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+                const MapModeStatsData& source = modeIt.value();
+                MapModeStatsData& target = into.stats[mapIt.key()][modeIt.key()];
+                target.totalWeightedPlays += source.totalWeightedPlays;
+                mergeEntries(target.brawlerStats, source.brawlerStats);
+                mergeEntries(target.synergyStats, source.synergyStats);
+                mergeEntries(target.counterStats, source.counterStats);
+                for (auto it = source.rankCounts.constBegin(); it != source.rankCounts.constEnd(); ++it) {
+                    target.rankCounts[it.key()].add(it.value());
+                }
+            }
+        }
+        into.hasRankCounts = into.hasRankCounts && delta.hasRankCounts;
+
+        into.allBrawlers.unite(delta.allBrawlers);
+        for (auto it = delta.discoveredMapModes.constBegin(); it != delta.discoveredMapModes.constEnd(); ++it) {
+            into.discoveredMapModes[it.key()].unite(it.value());
+        }
+        for (auto it = delta.metadata.ingestedOffsets.constBegin(); it != delta.metadata.ingestedOffsets.constEnd(); ++it) {
+            into.metadata.ingestedOffsets.insert(it.key(), it.value());
+        }
+
+        // Both sorted; keep the union sorted and unique
+        QVector<quint64> fingerprints;
+        fingerprints.reserve(into.metadata.battleFingerprints.size() + delta.metadata.battleFingerprints.size());
+        std::set_union(into.metadata.battleFingerprints.constBegin(), into.metadata.battleFingerprints.constEnd(),
+                       delta.metadata.battleFingerprints.constBegin(), delta.metadata.battleFingerprints.constEnd(),
+                       std::back_inserter(fingerprints));
+        into.metadata.battleFingerprints = std::move(fingerprints);
+    }
+
 } // namespace CacheUtils
\ No newline at end of file
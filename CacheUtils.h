@@ -13,6 +13,10 @@ namespace CacheUtils {
     // Loads CacheData from a file. Returns std::nullopt if file doesn't exist or fails to load.
     std::optional<CacheData> loadCache(const QString& filepath);
 
+    // Adds the weighted wins/plays of 'delta' into 'into' (append ingest).
+    // Brawlers and map/modes are unioned; ingest offsets from 'delta' win.
+    void mergeCacheData(CacheData& into, const CacheData& delta);
+
 } // namespace CacheUtils
 
 #endif // CACHEUTILS_H
\ No newline at end of file
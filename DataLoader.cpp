@@ -1,25 +1,42 @@
 #include "DataLoader.h"
+#include "StatsBuilder.h"
+#include "BattleLineParser.h"
 #include <QFile>
-#include <QTextStream>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDebug>
-#include <QMessageBox> // For error reporting if needed directly
+#include <algorithm> // For std::max
+#include <numeric>   // For std::accumulate
+#include <vector>
+#include <cstring>   // For std::memchr
+#include <cctype>
+#include <QtConcurrent/QtConcurrent>
 
 DataLoader::DataLoader(QString filepath, const AppConfig& config)
     : m_filepath(filepath), m_config(config) {}
 
-bool DataLoader::loadAndProcess() {
-    if (!loadRawData()) {
-        return false;
-    }
-    preprocessData();
-    // Check if essential data was discovered
-    return !m_allBrawlers.isEmpty() && !m_discoveredMapModes.isEmpty();
-}
-
-bool DataLoader::loadRawData() {
+struct DataLoader::Chunk {
+    qint64 begin = 0;     // Relative to the mapped start offset
+    qint64 end = 0;
+    bool lastChunk = false;
+    qint64 consumedEnd = 0; // End of the last line actually consumed
+    StatsBuilder builder;
+    IngestCounters counters;
+    QSet<QString> brawlers;
+    QHash<QString, QSet<QString>> mapModes;
+    struct ParsedGame {
+        quint64 fingerprint; // BattleDedup::fingerprint of the source record
+        ProcessedGame game;
+    };
+    QVector<ParsedGame> parsed; // Valid games in file order, then only the first copies
+    bool collectGames = false;
+    GameTable games; // Accepted games, if collecting
+
+    explicit Chunk(const ConfigSnapshot& config) : builder(config) {}
+};
+
+bool DataLoader::loadAndProcess(StatsBuilder& builder, GameTable* games) {
     QFile file(m_filepath);
     if (!file.exists()) {
          qCritical() << "Data file not found:" << m_filepath;
@@ -28,168 +45,310 @@ bool DataLoader::loadRawData() {
          return false;
     }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         qCritical() << "Failed to open data file:" << m_filepath << file.errorString();
         // Optional: QMessageBox::critical(nullptr, "Error", "Failed to open data file:\n" + file.errorString());
         return false;
     }
 
-    qInfo() << "Loading raw data from:" << m_filepath;
-    QTextStream in(&file);
-    int lineNum = 0;
-    while (!in.atEnd()) {
-        lineNum++;
-        QString line = in.readLine();
-        if (line.trimmed().isEmpty()) continue;
-
-        QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(line.toUtf8(), &parseError);
+    const qint64 fileSize = file.size();
+    if (m_startOffset > fileSize) {
+        qCritical() << "Data file is smaller than the ingested offset (" << m_startOffset << "), was it replaced?" << m_filepath;
+        return false;
+    }
 
-        if (parseError.error != QJsonParseError::NoError) {
-            qWarning() << "Skipping invalid JSON on line" << lineNum << ":" << parseError.errorString();
-            continue;
+    qInfo() << "Streaming game data from:" << m_filepath << "starting at byte" << m_startOffset;
+    m_processedGameCount = 0;
+    m_allBrawlers.clear();
+    m_discoveredMapModes.clear();
+    m_endOffset = m_startOffset;
+
+    // Map only the part not ingested yet; pages are read once and can be dropped by the OS
+    const qint64 length = fileSize - m_startOffset;
+    const char* data = nullptr;
+    if (length > 0) {
+        data = reinterpret_cast<const char*>(file.map(m_startOffset, length));
+        if (!data) {
+            qCritical() << "Failed to memory-map data file:" << m_filepath << file.errorString();
+            return false;
         }
+    }
 
-        if (!doc.isObject()) {
-             qWarning() << "Skipping non-object JSON on line" << lineNum;
-             continue;
+    // Newline-aligned chunk boundaries (depend only on the bytes, not the thread count)
+    QVector<QPair<qint64, qint64>> ranges;
+    for (qint64 pos = 0; pos < length; ) {
+        qint64 end = length;
+        if (length - pos > CHUNK_BYTES) {
+            const void* newline = std::memchr(data + pos + CHUNK_BYTES - 1, '\n', static_cast<size_t>(length - (pos + CHUNK_BYTES - 1)));
+            if (newline) end = static_cast<const char*>(newline) - data + 1;
         }
-
-        m_rawGames.append(doc.object());
+        ranges.append({pos, end});
+        pos = end;
     }
-    file.close();
-    qInfo() << "Loaded" << m_rawGames.size() << "raw game entries.";
-    return true;
-}
 
-void DataLoader::preprocessData() {
-    qInfo() << "Starting data preprocessing...";
-    int skippedCount = 0;
-    int rankIssues = 0;
-    int formatIssues = 0;
-    int missingPlayerTag = 0; // Keep track if needed, Python code had it
-    int processedCount = 0;
+    // Parse a batch of chunks in parallel, merge it with a fixed pairwise tree,
+    // then fold it into 'builder'. Only one batch of partial results exists at a time.
+    const ConfigSnapshot config = m_config.snapshot();
+    IngestCounters counters;
+    for (int batchStart = 0; batchStart < ranges.size(); batchStart += CHUNKS_PER_BATCH) {
+        const int batchSize = std::min<int>(CHUNKS_PER_BATCH, ranges.size() - batchStart);
+        std::vector<Chunk> chunks;
+        chunks.reserve(batchSize);
+        for (int i = 0; i < batchSize; ++i) {
+            chunks.emplace_back(config);
+            chunks.back().begin = ranges[batchStart + i].first;
+            chunks.back().end = ranges[batchStart + i].second;
+            chunks.back().lastChunk = (batchStart + i == ranges.size() - 1);
+            chunks.back().collectGames = games != nullptr;
+        }
 
-    m_processedGames.clear();
-    m_allBrawlers.clear();
-    m_discoveredMapModes.clear();
+        QtConcurrent::blockingMap(chunks, [this, data](Chunk& chunk) { parseChunk(data, chunk); });
+
+        // Resolve duplicates sequentially in file order, so the copy at the lowest
+        // offset always wins however the chunks were scheduled
+        for (Chunk& chunk : chunks) {
+            qsizetype kept = 0;
+            for (qsizetype i = 0; i < chunk.parsed.size(); ++i) {
+                if (chunk.parsed[i].fingerprint == 0) chunk.counters.missingBattleTime++; // Always kept
+                if (!m_seenBattles.insert(chunk.parsed[i].fingerprint)) {
+                    chunk.counters.duplicates++;
+                    continue;
+                }
+                if (kept != i) chunk.parsed[kept] = std::move(chunk.parsed[i]);
+                ++kept;
+            }
+            chunk.parsed.erase(chunk.parsed.begin() + kept, chunk.parsed.end());
+            chunk.counters.processed += static_cast<int>(kept);
+        }
 
-    for (int idx = 0; idx < m_rawGames.size(); ++idx) {
-        const QJsonObject& game = m_rawGames[idx];
+        QtConcurrent::blockingMap(chunks, [](Chunk& chunk) {
+            for (const Chunk::ParsedGame& parsed : std::as_const(chunk.parsed)) {
+                chunk.builder.addGame(parsed.game);
+                if (chunk.collectGames) chunk.games.append(parsed.game);
+            }
+            chunk.parsed = {}; // Free the batch's games before the merge
+        });
 
-        // Basic structure check
-        if (!game.contains("event") || !game["event"].isObject() ||
-            !game.contains("battle") || !game["battle"].isObject() ||
-            !game.contains("queried_player_tag") || !game["queried_player_tag"].isString())
-        {
-            formatIssues++; continue;
+        for (int stride = 1; stride < batchSize; stride *= 2) {
+            QVector<int> targets;
+            for (int i = 0; i + stride < batchSize; i += 2 * stride) {
+                targets.append(i);
+            }
+            QtConcurrent::blockingMap(targets, [&chunks, &config, stride](int target) {
+                chunks[target].builder.mergeFrom(chunks[target + stride].builder);
+                chunks[target + stride].builder = StatsBuilder(config); // Free merged chunk early
+            });
         }
+        builder.mergeFrom(chunks[0].builder);
+
+        // Small per-chunk bookkeeping, merged in file order
+        for (const Chunk& chunk : chunks) {
+            counters.processed += chunk.counters.processed;
+            counters.invalidJson += chunk.counters.invalidJson;
+            counters.rankIssues += chunk.counters.rankIssues;
+            counters.formatIssues += chunk.counters.formatIssues;
+            counters.missingPlayerTag += chunk.counters.missingPlayerTag;
+            counters.duplicates += chunk.counters.duplicates;
+            counters.missingBattleTime += chunk.counters.missingBattleTime;
+            m_allBrawlers.unite(chunk.brawlers);
+            if (games) games->appendTable(chunk.games);
+            for (auto it = chunk.mapModes.constBegin(); it != chunk.mapModes.constEnd(); ++it) {
+                m_discoveredMapModes[it.key()].unite(it.value());
+            }
+        }
+        m_endOffset = m_startOffset + chunks.back().consumedEnd;
+    }
 
-        QJsonObject event = game["event"].toObject();
-        QJsonObject battle = game["battle"].toObject();
-        QString queriedPlayerTag = game["queried_player_tag"].toString();
+    if (data) file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+    file.close();
 
-        // Event details check
-        if (!event.contains("mode") || !event["mode"].isString() ||
-            !event.contains("map") || !event["map"].isString())
-        {
-             formatIssues++; continue;
+    builder.finishIngest(m_allBrawlers);
+    m_processedGameCount = counters.processed;
+    logSummary(counters);
+    // Check if essential data was discovered
+    return !m_allBrawlers.isEmpty() && !m_discoveredMapModes.isEmpty();
+}
+
+// Parses and validates the lines of one chunk into chunk.parsed (runs on a worker thread)
+void DataLoader::parseChunk(const char* data, Chunk& chunk) const {
+    auto isBlank = [](const char* p, qint64 n) {
+        for (qint64 i = 0; i < n; ++i) {
+            if (!std::isspace(static_cast<unsigned char>(p[i]))) return false;
         }
-        QString mode = event["mode"].toString();
-        QString mapName = event["map"].toString();
-        if (mode.isEmpty() || mapName.isEmpty()) {
-             formatIssues++; continue;
+        return true;
+    };
+
+    chunk.consumedEnd = chunk.begin;
+    for (qint64 pos = chunk.begin; pos < chunk.end; ) {
+        const void* newline = std::memchr(data + pos, '\n', static_cast<size_t>(chunk.end - pos));
+        const bool complete = newline != nullptr;
+        const qint64 lineEnd = complete ? static_cast<const char*>(newline) - data + 1 : chunk.end;
+        const qint64 lineStart = pos;
+        pos = lineEnd;
+        if (complete) chunk.consumedEnd = lineEnd;
+        if (isBlank(data + lineStart, lineEnd - lineStart)) continue;
+
+        // Fast path for the usual clean line; anything else goes through QJsonDocument
+        BattleRecord record;
+        if (BattleLineParser::parse(data + lineStart, lineEnd - lineStart, record)) {
+            if (!complete) chunk.consumedEnd = lineEnd; // Valid final line without a newline
+            resolveGame(record, m_startOffset + lineStart, chunk);
+            continue;
         }
 
+        // No copy: the parser reads straight from the mapped UTF-8 bytes
+        QByteArray line = QByteArray::fromRawData(data + lineStart, lineEnd - lineStart);
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
 
-        // Battle details check
-        if (!battle.contains("result") || !battle["result"].isString() ||
-            !battle.contains("teams") || !battle["teams"].isArray())
-        {
-             formatIssues++; continue;
+        if (parseError.error != QJsonParseError::NoError) {
+            if (!complete && chunk.lastChunk) {
+                // Unterminated last line that doesn't parse: the scraper is probably
+                // still writing it. Leave it for the next append.
+                qInfo() << "Leaving partial last line for the next ingest.";
+                break;
+            }
+            qWarning() << "Skipping invalid JSON at byte" << m_startOffset + lineStart << ":" << parseError.errorString();
+            chunk.counters.invalidJson++;
+            continue;
         }
-        QString result = battle["result"].toString();
-        QJsonArray teamsRaw = battle["teams"].toArray();
+        if (!complete) chunk.consumedEnd = lineEnd; // Valid final line without a newline
 
-        if (result.isEmpty() || teamsRaw.size() < 2) {
-             formatIssues++; continue;
+        if (!doc.isObject()) {
+             qWarning() << "Skipping non-object JSON at byte" << m_startOffset + lineStart;
+             chunk.counters.invalidJson++;
+             continue;
         }
 
-        // Extract and validate team data
-        auto [team1Data, team1Valid] = extractTeamData(teamsRaw.at(0));
-        auto [team2Data, team2Valid] = extractTeamData(teamsRaw.at(1));
+        processGame(doc.object(), m_startOffset + lineStart, chunk);
+    }
+}
 
-        if (!team1Valid || !team2Valid) {
-            rankIssues++; continue; // Covers invalid player/rank data or team size != 3
-        }
+// Validates one battle log entry and splits it into winners/losers. Brawlers and
+// map/modes are recorded as discovered even if the game is dropped later on.
+void DataLoader::processGame(const QJsonObject& game, qint64 lineOffset, Chunk& chunk) const {
+    IngestCounters& counters = chunk.counters;
+    // Basic structure check
+    if (!game.contains("event") || !game["event"].isObject() ||
+        !game.contains("battle") || !game["battle"].isObject() ||
+        !game.contains("queried_player_tag") || !game["queried_player_tag"].isString())
+    {
+        counters.formatIssues++; return;
+    }
 
-        // Discover brawlers and map/modes
-        for(const auto& p : team1Data) m_allBrawlers.insert(p.brawlerName);
-        for(const auto& p : team2Data) m_allBrawlers.insert(p.brawlerName);
-        m_discoveredMapModes[mode].insert(mapName); // QHash automatically creates entry if mode is new
-
-        // Check if queried player is in the game (Python logic included this)
-        bool playerInT1 = false;
-        if (teamsRaw.at(0).isArray()){
-            for(const QJsonValue& playerVal : teamsRaw.at(0).toArray()){
-                if (playerVal.isObject() && playerVal.toObject().value("tag").toString() == queriedPlayerTag) {
-                    playerInT1 = true; break;
-                }
-            }
-        }
-        bool playerInT2 = false;
-         if (teamsRaw.at(1).isArray()){
-            for(const QJsonValue& playerVal : teamsRaw.at(1).toArray()){
-                if (playerVal.isObject() && playerVal.toObject().value("tag").toString() == queriedPlayerTag) {
-                    playerInT2 = true; break;
-                }
-            }
-        }
-        if (!playerInT1 && !playerInT2) {
-            missingPlayerTag++; continue;
-        }
+    QJsonObject event = game["event"].toObject();
+    QJsonObject battle = game["battle"].toObject();
+    QString queriedPlayerTag = game["queried_player_tag"].toString();
+
+    // Event details check
+    if (!event.contains("mode") || !event["mode"].isString() ||
+        !event.contains("map") || !event["map"].isString())
+    {
+         counters.formatIssues++; return;
+    }
+    QString mode = event["mode"].toString();
+    QString mapName = event["map"].toString();
+    if (mode.isEmpty() || mapName.isEmpty()) {
+         counters.formatIssues++; return;
+    }
 
 
-        // Determine winning/losing teams based on result and player presence
-        QVector<PlayerData> winningTeamData;
-        QVector<PlayerData> losingTeamData;
+    // Battle details check
+    if (!battle.contains("result") || !battle["result"].isString() ||
+        !battle.contains("teams") || !battle["teams"].isArray())
+    {
+         counters.formatIssues++; return;
+    }
+    QString result = battle["result"].toString();
+    QJsonArray teamsRaw = battle["teams"].toArray();
+
+    if (result.isEmpty() || teamsRaw.size() < 2) {
+         counters.formatIssues++; return;
+    }
 
-        if ((playerInT1 && result == "victory") || (playerInT2 && result == "defeat")) {
-            winningTeamData = team1Data;
-            losingTeamData = team2Data;
-        } else if ((playerInT1 && result == "defeat") || (playerInT2 && result == "victory")) {
-            winningTeamData = team2Data;
-            losingTeamData = team1Data;
-        } else if (result == "draw" || result == "draw!") { // Handle draws explicitly if necessary (skip?)
-             formatIssues++; continue; // Or handle differently if draws provide info
+    // Extract and validate team data
+    BattleRecord record;
+    record.mode = mode;
+    record.map = mapName;
+    record.result = result;
+    record.queriedPlayerTag = queriedPlayerTag;
+    record.battleTime = game.value("battleTime").toString(); // Top level, next to "battle"
+    for (int t = 0; t < 2; ++t) {
+        auto [teamData, teamValid] = extractTeamData(teamsRaw.at(t));
+        if (!teamValid) {
+            counters.rankIssues++; return; // Covers invalid player/rank data or team size != 3
         }
-        else {
-            // This case might indicate player tag missing or inconsistent result/tag data
-            qWarning() << "Skipping game index" << idx << "- inconsistent result/tag:" << result << "T1?" << playerInT1 << "T2?" << playerInT2;
-            formatIssues++; continue;
+        record.teams[t] = teamData;
+        for (const QJsonValue& playerVal : teamsRaw.at(t).toArray()) {
+            record.tags[t].append(playerVal.toObject().value("tag").toString());
         }
+    }
+
+    resolveGame(record, lineOffset, chunk);
+}
+
+// Shared tail of both parse paths: discovery, then winners/losers from the
+// queried player's side and the result
+void DataLoader::resolveGame(const BattleRecord& record, qint64 lineOffset, Chunk& chunk) const {
+    IngestCounters& counters = chunk.counters;
+    const QVector<PlayerData>& team1Data = record.teams[0];
+    const QVector<PlayerData>& team2Data = record.teams[1];
+    const QString& result = record.result;
+
+    // Discover brawlers and map/modes
+    for(const auto& p : team1Data) chunk.brawlers.insert(p.brawlerName);
+    for(const auto& p : team2Data) chunk.brawlers.insert(p.brawlerName);
+    chunk.mapModes[record.mode].insert(record.map); // QHash automatically creates entry if mode is new
+
+    // Check if queried player is in the game (Python logic included this)
+    bool playerInT1 = record.tags[0].contains(record.queriedPlayerTag);
+    bool playerInT2 = record.tags[1].contains(record.queriedPlayerTag);
+    if (!playerInT1 && !playerInT2) {
+        counters.missingPlayerTag++; return;
+    }
 
-        // Add processed game
-        m_processedGames.append({mode, mapName, winningTeamData, losingTeamData});
-        processedCount++;
 
-    } // End game loop
+    // Determine winning/losing teams based on result and player presence
+    QVector<PlayerData> winningTeamData;
+    QVector<PlayerData> losingTeamData;
+
+    if ((playerInT1 && result == "victory") || (playerInT2 && result == "defeat")) {
+        winningTeamData = team1Data;
+        losingTeamData = team2Data;
+    } else if ((playerInT1 && result == "defeat") || (playerInT2 && result == "victory")) {
+        winningTeamData = team2Data;
+        losingTeamData = team1Data;
+    } else if (result == "draw" || result == "draw!") { // Handle draws explicitly if necessary (skip?)
+         counters.formatIssues++; return; // Or handle differently if draws provide info
+    }
+    else {
+        // This case might indicate player tag missing or inconsistent result/tag data
+        qWarning() << "Skipping game at byte" << lineOffset << "- inconsistent result/tag:" << result << "T1?" << playerInT1 << "T2?" << playerInT2;
+        counters.formatIssues++; return;
+    }
+
+    // Only valid games claim the fingerprint (another player's copy may still be
+    // usable); loadAndProcess resolves duplicates once the batch is parsed
+    chunk.parsed.append({BattleDedup::fingerprint(record), ProcessedGame{record.mode, record.map, winningTeamData, losingTeamData}});
+}
 
+void DataLoader::logSummary(const IngestCounters& counters) const {
     qInfo() << "Discovered" << m_discoveredMapModes.size() << "modes and"
             << std::accumulate(m_discoveredMapModes.begin(), m_discoveredMapModes.end(), 0,
                                [](int sum, const QSet<QString>& maps){ return sum + maps.size(); })
             << "unique maps.";
     qInfo() << "Identified" << m_allBrawlers.size() << "unique brawlers.";
-    qInfo() << "Successfully processed" << processedCount << "game entries.";
-    if (skippedCount > 0) qWarning() << "Skipped" << skippedCount << "games due to unexpected processing errors.";
-    if (rankIssues > 0) qWarning() << "Skipped" << rankIssues << "games due to invalid player/rank data or team size.";
-    if (formatIssues > 0) qWarning() << "Skipped" << formatIssues << "games due to other format issues.";
-    if (missingPlayerTag > 0) qWarning() << "Skipped" << missingPlayerTag << "games because queried player tag was missing from teams.";
-
+    qInfo() << "Successfully processed" << counters.processed << "game entries.";
+    if (counters.invalidJson > 0) qWarning() << "Skipped" << counters.invalidJson << "lines that were not valid JSON objects.";
+    if (counters.rankIssues > 0) qWarning() << "Skipped" << counters.rankIssues << "games due to invalid player/rank data or team size.";
+    if (counters.formatIssues > 0) qWarning() << "Skipped" << counters.formatIssues << "games due to other format issues.";
+    if (counters.missingPlayerTag > 0) qWarning() << "Skipped" << counters.missingPlayerTag << "games because queried player tag was missing from teams.";
+    if (counters.duplicates > 0) qInfo() << "Dropped" << counters.duplicates << "duplicate copies of battles already counted.";
+    if (counters.missingBattleTime > 0) qWarning() << counters.missingBattleTime << "games had no battleTime and could not be checked for duplicates.";
 }
 
 // Helper to extract team data from a QJsonValue (expected to be QJsonArray)
-QPair<QVector<PlayerData>, bool> DataLoader::extractTeamData(const QJsonValue& teamValue) {
+QPair<QVector<PlayerData>, bool> DataLoader::extractTeamData(const QJsonValue& teamValue) const {
     QVector<PlayerData> teamData;
     if (!teamValue.isArray()) return {{}, false}; // Check if it's an array
 
@@ -222,9 +381,26 @@ QPair<QVector<PlayerData>, bool> DataLoader::extractTeamData(const QJsonValue& t
 }
 
 
+void DataLoader::setStartOffset(qint64 offset) {
+    m_startOffset = std::max<qint64>(0, offset);
+}
+
+qint64 DataLoader::endOffset() const {
+    return m_endOffset;
+}
+
+void DataLoader::setKnownBattles(const QVector<quint64>& fingerprints) {
+    m_seenBattles.insertAll(fingerprints);
+}
+
+QVector<quint64> DataLoader::battleFingerprints() const {
+    return m_seenBattles.sortedValues();
+}
+
+
 // --- Getters ---
-const QVector<ProcessedGame>& DataLoader::getProcessedGames() const {
-    return m_processedGames;
+int DataLoader::processedGameCount() const {
+    return m_processedGameCount;
 }
 
 const QSet<QString>& DataLoader::getAllBrawlers() const {
@@ -11,29 +11,70 @@
 #include <QJsonValue>   // <-- ADD (Used in extractTeamData signature)
 #include "DataStructures.h"
 #include "AppConfig.h"
+#include "BattleDedup.h"
+#include "GameTable.h"
 
+class StatsBuilder;
+
+// Streams the JSONL battle log: each line is parsed, validated and handed to
+// a StatsBuilder straight away, so memory stays flat however big the file is.
+// The file is memory-mapped and split into newline-aligned chunks that are
+// parsed on worker threads, each into its own builder; results are merged in
+// a fixed order so the stats don't depend on the thread count. Copies of the
+// same battle (one per queried player) are counted once: the one at the
+// lowest file offset is kept, see BattleDedup.
 class DataLoader {
 public:
     DataLoader(QString filepath, const AppConfig& config);
 
-    bool loadAndProcess();
+    // Feeds every valid game into 'builder' (addGame), then finishIngest().
+    // If 'games' is set, the accepted games are also appended to it in file order.
+    bool loadAndProcess(StatsBuilder& builder, GameTable* games = nullptr);
+
+    // Append mode: skip the first 'offset' bytes (already ingested into the cache)
+    void setStartOffset(qint64 offset);
+    // Byte offset just past the last complete line read; store it as the new ingest point
+    qint64 endOffset() const;
+    // Battles already counted by earlier ingests (from the stats pack); copies are dropped
+    void setKnownBattles(const QVector<quint64>& fingerprints);
+    // Known battles plus the ones counted by this load, sorted (store in CacheMetadata)
+    QVector<quint64> battleFingerprints() const;
 
-    const QVector<ProcessedGame>& getProcessedGames() const;
+    int processedGameCount() const;
     const QSet<QString>& getAllBrawlers() const;
     const QHash<QString, QSet<QString>>& getDiscoveredMapModes() const;
 
 private:
-    bool loadRawData();
-    void preprocessData();
-    QPair<QVector<PlayerData>, bool> extractTeamData(const QJsonValue& teamValue); // Use QJsonValue
+    // Why lines/games were dropped, logged once at the end
+    struct IngestCounters {
+        int processed = 0;
+        int invalidJson = 0;
+        int rankIssues = 0;
+        int formatIssues = 0;
+        int missingPlayerTag = 0;
+        int duplicates = 0;
+        int missingBattleTime = 0; // Kept, but can't be deduplicated
+    };
+
+    static constexpr qint64 CHUNK_BYTES = 4 * 1024 * 1024; // Target chunk size, extended to the next newline
+    static constexpr int CHUNKS_PER_BATCH = 64;            // Chunks (and builders) alive at once
+
+    struct Chunk; // Per-chunk builder, discoveries and counters (DataLoader.cpp)
+    void parseChunk(const char* data, Chunk& chunk) const;
+    void processGame(const QJsonObject& game, qint64 lineOffset, Chunk& chunk) const;
+    void resolveGame(const BattleRecord& record, qint64 lineOffset, Chunk& chunk) const;
+    QPair<QVector<PlayerData>, bool> extractTeamData(const QJsonValue& teamValue) const; // Use QJsonValue
+    void logSummary(const IngestCounters& counters) const;
 
     QString m_filepath;
     const AppConfig& m_config; // Store reference to config
+    qint64 m_startOffset = 0;
+    qint64 m_endOffset = 0;
+    BattleDedup m_seenBattles; // Filled in file order after each batch is parsed
 
-    QVector<QJsonObject> m_rawGames; // Store raw JSON objects initially
-    QVector<ProcessedGame> m_processedGames;
+    int m_processedGameCount = 0;
     QSet<QString> m_allBrawlers;
     QHash<QString, QSet<QString>> m_discoveredMapModes;
 };
 
-#endif // DATALOADER_H
\ No newline at end of file
+#endif // DATALOADER_H
@@ -1,4 +1,5 @@
 #include "DataStructures.h"
+#include <algorithm> // For std::sort
 
 // --- Serialization for BrawlerStatsData ---
 QDataStream &operator<<(QDataStream &out, const BrawlerStatsData &stats) {
@@ -23,13 +24,33 @@ QDataStream &operator>>(QDataStream &in, MapModeStatsData &stats) {
 }
 
 
+quint64 ingestStamp(const CacheMetadata& meta) {
+    constexpr quint64 FNV_PRIME = 0x100000001b3ULL;
+    quint64 h = 0xcbf29ce484222325ULL;
+    auto mix = [&h](quint64 value) { h = (h ^ value) * FNV_PRIME; };
+
+    QStringList sources = meta.ingestedOffsets.keys();
+    std::sort(sources.begin(), sources.end()); // QHash order isn't stable
+    for (const QString& source : sources) {
+        for (QChar c : source) mix(c.unicode());
+        mix(static_cast<quint64>(meta.ingestedOffsets.value(source)));
+    }
+    mix(static_cast<quint64>(meta.battleFingerprints.size()));
+    for (quint64 fingerprint : meta.battleFingerprints) mix(fingerprint);
+    return h;
+}
+
 // --- Serialization for CacheMetadata ---
 QDataStream &operator<<(QDataStream &out, const CacheMetadata &meta) {
-    out << meta.cacheCreationTime;
+    out << meta.cacheCreationTime << meta.ingestedOffsets;
     return out;
 }
 QDataStream &operator>>(QDataStream &in, CacheMetadata &meta) {
     in >> meta.cacheCreationTime;
+    // Version 1 caches stop here; they have no ingest record
+    if (!in.atEnd()) {
+        in >> meta.ingestedOffsets;
+    }
     return in;
 }
 
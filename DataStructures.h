@@ -7,32 +7,38 @@
 #include <QVector>
 #include <QDataStream>
 #include <limits>
-#include <atomic>
+#include <vector>
+#include <new> // For aligned operator new
+#include <algorithm> // For std::clamp
 #include <QMetaType>
 
-// --- Basic Stats Structs ---
+#include "BrawlerRegistry.h" // For BrawlerId and pair keys
 
-void atomic_add_double(std::atomic<double>& atomic_var, double value);
+// --- Basic Stats Structs ---
 
+// Plain accumulators: only StatsBuilder writes these, single threaded
 struct BrawlerStats {
-    std::atomic<double> wins{0.0};
-    std::atomic<double> plays{0.0};
-
-    // Need default constructor for QHash/maps
-    BrawlerStats() = default;
-    // Copy constructor needed for atomic members
-    BrawlerStats(const BrawlerStats& other) : wins(other.wins.load()), plays(other.plays.load()) {}
-    // Assignment operator needed for atomic members
-    BrawlerStats& operator=(const BrawlerStats& other) {
-        if (this != &other) {
-            wins.store(other.wins.load());
-            plays.store(other.plays.load());
+    double wins = 0.0;
+    double plays = 0.0;
+};
+
+// Unweighted games of one brawler per rank, so the rank weighting (and a rank
+// window) can be applied when the stats are read instead of at ingest
+struct RankCounts {
+    static constexpr int BUCKETS = 64; // Ranks 0-62 exactly, the last bucket holds 63 and up
+    quint32 wins[BUCKETS] = {};
+    quint32 plays[BUCKETS] = {};
+
+    static int bucket(int rank) { return std::clamp(rank, 0, BUCKETS - 1); }
+    void add(const RankCounts& other) {
+        for (int i = 0; i < BUCKETS; ++i) {
+            wins[i] += other.wins[i];
+            plays[i] += other.plays[i];
         }
-        return *this;
     }
 };
 
-// Need non-atomic version for serialization
+// Serialized form (same fields, kept separate from the in-memory type)
 struct BrawlerStatsData {
     double wins = 0.0;
     double plays = 0.0;
@@ -43,25 +49,20 @@ QDataStream &operator>>(QDataStream &in, BrawlerStatsData &stats);
 
 
 struct MapModeStats {
-    // Use QHash for faster lookups, similar to Python dict
-    QHash<QString, BrawlerStats> brawlerStats;
-    QHash<QString, BrawlerStats> synergyStats; // Key: Sorted "Brawler1|Brawler2"
-    QHash<QString, BrawlerStats> counterStats; // Key: "BrawlerUs|BrawlerThem"
-    std::atomic<double> totalWeightedPlays{0.0};
-
-    // Default constructor
-    MapModeStats() = default;
-    // Copy constructor for atomic members
-    MapModeStats(const MapModeStats& other);
-    // Assignment operator for atomic members
-    MapModeStats& operator=(const MapModeStats& other);
+    // Keyed by BrawlerId / packed id pairs so lookups never build strings
+    QHash<BrawlerId, BrawlerStats> brawlerStats;
+    QHash<quint32, BrawlerStats> synergyStats; // Key: sortedPairKey(id1, id2)
+    QHash<quint32, BrawlerStats> counterStats; // Key: counterPairKey(idUs, idThem)
+    QHash<BrawlerId, RankCounts> rankCounts;
+    double totalWeightedPlays = 0.0;
 };
 
-// Need non-atomic version for serialization
+// Serialized form (name-keyed, as stored in stats.pack)
 struct MapModeStatsData {
      QHash<QString, BrawlerStatsData> brawlerStats;
      QHash<QString, BrawlerStatsData> synergyStats;
      QHash<QString, BrawlerStatsData> counterStats;
+     QHash<QString, RankCounts> rankCounts; // stats.pack only, not in the legacy QDataStream cache
      double totalWeightedPlays = 0.0;
 };
 
@@ -69,6 +70,49 @@ QDataStream &operator<<(QDataStream &out, const MapModeStatsData &stats);
 QDataStream &operator>>(QDataStream &in, MapModeStatsData &stats);
 
 
+// --- Precomputed Score Tables ---
+
+// Minimal allocator returning cache-line aligned storage (C++17 aligned new)
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Dense per map/mode tables derived from MapModeStats once at build time, so the
+// heuristics read array entries instead of smoothing raw stats on every call.
+// Indexed by BrawlerId; the N x N matrices are row-major. Non-owning: the arrays
+// live in a StatsPack (mapped file or in-memory image).
+struct MapModeTables {
+    int brawlerCount = 0;
+    double totalWeightedPlays = 0.0;
+    const double* winRates = nullptr;  // Smoothed, confidence-adjusted win rate
+    const double* pickRates = nullptr; // 0.0 when the map/mode has no plays
+    const float* synergy = nullptr;    // [a * N + b], symmetric, 0.5 if no data
+    const float* counter = nullptr;    // [us * N + them], 0.5 if no data
+
+    double winRate(BrawlerId b) const { return winRates[b]; }
+    double pickRate(BrawlerId b) const { return pickRates[b]; }
+    double synergyScore(BrawlerId a, BrawlerId b) const { return synergy[a * brawlerCount + b]; }
+    double counterScore(BrawlerId us, BrawlerId them) const { return counter[us * brawlerCount + them]; }
+};
+
+
 // --- Heuristic Structs ---
 
 struct HeuristicWeights {
@@ -116,6 +160,18 @@ struct ProcessedGame {
     QVector<PlayerData> losingTeamData;
 };
 
+// The fields of one battle log line that ingest looks at, after the structural
+// checks (filled by the Qt JSON path or BattleLineParser)
+struct BattleRecord {
+    QString mode;
+    QString map;
+    QString result;
+    QString queriedPlayerTag;
+    QString battleTime;           // Empty if the line has none (then it can't be deduplicated)
+    QVector<PlayerData> teams[2]; // First two teams, 3 players each
+    QVector<QString> tags[2];     // Player tags, same order as teams
+};
+
 
 // --- Cache Data Structure ---
 // Use QHash for stats as it's efficient for lookups
@@ -123,8 +179,18 @@ using StatsContainer = QHash<QString, QHash<QString, MapModeStatsData>>;
 
 struct CacheMetadata {
     qint64 cacheCreationTime = 0;
+    // Source file name -> bytes already folded into the stats (cache version 2+).
+    // Append ingest resumes from here instead of reprocessing the whole file.
+    QHash<QString, qint64> ingestedOffsets;
+    // Sorted fingerprints of the battles already counted (see BattleDedup), so
+    // copies of a battle that show up in a later append are dropped too.
+    // Stored in stats.pack only; the legacy QDataStream cache never had them.
+    QVector<quint64> battleFingerprints;
     // Add config parameters if strict validation is needed later
 };
+// Identifies what has been ingested (sources, offsets and battles, not the
+// creation time). games.bin stores it to show it holds the same games as the pack.
+quint64 ingestStamp(const CacheMetadata& meta);
 QDataStream &operator<<(QDataStream &out, const CacheMetadata &meta);
 QDataStream &operator>>(QDataStream &in, CacheMetadata &meta);
 
@@ -134,13 +200,16 @@ struct CacheData {
     QSet<QString> allBrawlers;
     QHash<QString, QSet<QString>> discoveredMapModes;
     CacheMetadata metadata;
+    // False if any of the stats predate rank counts (legacy cache); partial
+    // counts would skew the rates, so none are packed then
+    bool hasRankCounts = false;
 };
 
 QDataStream &operator<<(QDataStream &out, const CacheData &data);
 QDataStream &operator>>(QDataStream &in, CacheData &data);
 
 
-// Helper for sorting pairs for synergy/counter keys
+// Helper for sorting pairs for synergy/counter keys in the cache format
 inline QString sortedPairKey(const QString& b1, const QString& b2) {
     return (b1 < b2) ? b1 + "|" + b2 : b2 + "|" + b1;
 }
@@ -149,40 +218,4 @@ inline QString counterPairKey(const QString& bUs, const QString& bThem) {
     return bUs + "|" + bThem;
 }
 
-// Explicit implementations for copy constructor/assignment for MapModeStats
-inline MapModeStats::MapModeStats(const MapModeStats& other)
-    : totalWeightedPlays(other.totalWeightedPlays.load())
-{
-    // Deep copy the maps, handling atomic BrawlerStats
-    for (auto it = other.brawlerStats.constBegin(); it != other.brawlerStats.constEnd(); ++it) {
-        brawlerStats.insert(it.key(), it.value()); // Calls BrawlerStats copy constructor
-    }
-     for (auto it = other.synergyStats.constBegin(); it != other.synergyStats.constEnd(); ++it) {
-        synergyStats.insert(it.key(), it.value());
-    }
-     for (auto it = other.counterStats.constBegin(); it != other.counterStats.constEnd(); ++it) {
-        counterStats.insert(it.key(), it.value());
-    }
-}
-
-inline MapModeStats& MapModeStats::operator=(const MapModeStats& other) {
-    if (this != &other) {
-        totalWeightedPlays.store(other.totalWeightedPlays.load());
-        brawlerStats.clear();
-        synergyStats.clear();
-        counterStats.clear();
-        for (auto it = other.brawlerStats.constBegin(); it != other.brawlerStats.constEnd(); ++it) {
-            brawlerStats.insert(it.key(), it.value()); // Calls BrawlerStats copy constructor/assignment
-        }
-        for (auto it = other.synergyStats.constBegin(); it != other.synergyStats.constEnd(); ++it) {
-            synergyStats.insert(it.key(), it.value());
-        }
-        for (auto it = other.counterStats.constBegin(); it != other.counterStats.constEnd(); ++it) {
-            counterStats.insert(it.key(), it.value());
-        }
-    }
-    return *this;
-}
-
-
 #endif // DATASTRUCTURES_H
\ No newline at end of file
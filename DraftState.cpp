@@ -1,165 +1,247 @@
 #include "DraftState.h"
 #include <QDebug>
+#include <QStringList>
+#include <algorithm> // For std::find
+#include <array>
 #include <stdexcept> // For exceptions
-#include <algorithm> // For std::sort
-
-DraftState::DraftState(QString map, QString mode, const QSet<QString>& allBrawlers,
-                       QSet<QString> bans, QVector<QString> team1Picks,
-                       QVector<QString> team2Picks, QString turn, int pickNumber)
-    : m_map(map), m_mode(mode), m_masterBrawlerList(allBrawlers),
-      m_bans(bans), m_team1Picks(team1Picks), m_team2Picks(team2Picks),
-      m_turn(turn), m_pickNumber(pickNumber)
-{
-    // Initial calculation of available brawlers
-    updateAvailable();
+#include <string>
+
+namespace {
+
+    // splitmix64: fixed seed so hashes are the same from run to run
+    quint64 splitMix(quint64& x) {
+        quint64 z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
 
-    // Basic validation on creation (optional, but helpful)
-    if (!isValid()) {
-        qWarning() << "Created potentially invalid DraftState:" << toString();
-        // Optionally throw or handle differently
+    // [team 1 picks | team 2 picks | bans] x brawler
+    const std::array<quint64, 3 * DraftState::MAX_BRAWLERS> ZOBRIST_KEYS = [] {
+        std::array<quint64, 3 * DraftState::MAX_BRAWLERS> keys{};
+        quint64 state = 0x5a0b7157d7a1f7edULL;
+        for (quint64& key : keys) key = splitMix(state);
+        return keys;
+    }();
+
+} // namespace
+
+BrawlerId BrawlerMask::nth(int n) const {
+    for (int i = 0; i < CAPACITY / 64; ++i) {
+        int inWord = qPopulationCount(words[i]);
+        if (n >= inWord) {
+            n -= inWord;
+            continue;
+        }
+        quint64 w = words[i];
+        for (; n > 0; --n) w &= w - 1; // Drop the lower set bits
+        return static_cast<BrawlerId>(i * 64 + qCountTrailingZeroBits(w));
     }
+    return INVALID_BRAWLER_ID;
+}
+
+
+quint64 DraftState::pickKey(int team, BrawlerId brawler) {
+    return ZOBRIST_KEYS[team * MAX_BRAWLERS + brawler];
+}
+
+quint64 DraftState::banKey(BrawlerId brawler) {
+    return ZOBRIST_KEYS[2 * MAX_BRAWLERS + brawler];
 }
 
-QString DraftState::mapName() const { return m_map; }
-QString DraftState::modeName() const { return m_mode; }
-const QSet<QString>& DraftState::bans() const { return m_bans; }
-const QVector<QString>& DraftState::team1Picks() const { return m_team1Picks; }
-const QVector<QString>& DraftState::team2Picks() const { return m_team2Picks; }
-QString DraftState::currentTurn() const { return m_turn; }
-int DraftState::currentPickNumber() const { return m_pickNumber; }
-const QSet<QString>& DraftState::availableBrawlers() const { return m_available; }
 
+DraftState::DraftState(int mapModeId, int brawlerCount)
+    : m_mapModeId(mapModeId)
+{
+    quint64 seed = quint64(quint32(mapModeId));
+    m_hash = splitMix(seed); // Different map/modes never share a position
+    if (brawlerCount > MAX_BRAWLERS) {
+        qWarning() << "Draft supports" << MAX_BRAWLERS << "brawlers," << brawlerCount << "known; the rest can't be picked.";
+        brawlerCount = MAX_BRAWLERS;
+    }
+    for (int id = 0; id < brawlerCount; ++id) {
+        m_available.set(static_cast<BrawlerId>(id));
+    }
+}
 
-bool DraftState::isComplete() const {
-    // Draft is complete after 6 picks (pickNumber becomes 7)
-    return m_pickNumber > 6;
+QVector<BrawlerId> DraftState::teamPicks(Turn team) const {
+    const int t = teamIndex(team);
+    QVector<BrawlerId> picks;
+    picks.reserve(m_pickCount[t]);
+    for (int i = 0; i < m_pickCount[t]; ++i) picks.append(m_picks[t][i]);
+    return picks;
 }
 
+
 bool DraftState::isValid() const {
     // Basic sanity checks
-    if (m_team1Picks.size() > 3 || m_team2Picks.size() > 3 || m_bans.size() > 6) {
+    if (m_pickCount[0] > TEAM_SIZE || m_pickCount[1] > TEAM_SIZE || m_banCount > MAX_BANS ||
+        m_banCount != m_bans.count() || m_pickNumber != m_pickCount[0] + m_pickCount[1] + 1) {
         return false;
     }
-    // Check for duplicate picks/bans
-    QSet<QString> pickedOrBanned = m_bans;
-    for(const auto& p : m_team1Picks) pickedOrBanned.insert(p);
-    for(const auto& p : m_team2Picks) pickedOrBanned.insert(p);
-    if (pickedOrBanned.size() != m_bans.size() + m_team1Picks.size() + m_team2Picks.size()) {
-        return false; // Duplicates found
-    }
-    // Check if all picked/banned are in master list
-    for(const auto& b : pickedOrBanned) {
-        if (!m_masterBrawlerList.contains(b)) return false;
+    // Check for duplicate picks/bans: every brawler is in at most one place
+    if (m_bans.intersects(m_available)) return false;
+    BrawlerMask picked;
+    for (int t = 0; t < 2; ++t) {
+        for (int i = 0; i < m_pickCount[t]; ++i) {
+            BrawlerId id = m_picks[t][i];
+            if (picked.test(id) || m_bans.test(id) || m_available.test(id)) return false;
+            picked.set(id);
+        }
     }
     return true;
 }
 
 
-DraftState DraftState::applyMove(const QString& brawler) const {
+DraftState::Turn DraftState::turnForPick(int pickNumber) {
+    // Pick 1 (by T1) -> T2's turn (Pick 2)
+    // Pick 2 (by T2) -> T2's turn (Pick 3)
+    // Pick 3 (by T2) -> T1's turn (Pick 4)
+    // Pick 4 (by T1) -> T1's turn (Pick 5)
+    // Pick 5 (by T1) -> T2's turn (Pick 6)
+    // Pick 6 (by T2) -> Complete (Pick 7)
+    static constexpr Turn ORDER[TOTAL_PICKS] = {Turn::Team1, Turn::Team2, Turn::Team2, Turn::Team1, Turn::Team1, Turn::Team2};
+    return (pickNumber >= 1 && pickNumber <= TOTAL_PICKS) ? ORDER[pickNumber - 1] : Turn::Complete;
+}
+
+QString DraftState::turnName(Turn turn) {
+    switch (turn) {
+    case Turn::Team1: return QStringLiteral("team1");
+    case Turn::Team2: return QStringLiteral("team2");
+    default: return QString();
+    }
+}
+
+
+DraftState DraftState::applyMove(BrawlerId brawler) const {
     if (isComplete()) {
         throw std::logic_error("Illegal move: Draft is already complete.");
     }
-    if (!m_available.contains(brawler)) {
-         throw std::invalid_argument("Illegal move: Brawler '" + brawler.toStdString() + "' is not available.");
+    if (!m_available.test(brawler)) {
+        throw std::invalid_argument("Illegal move: Brawler " + std::to_string(brawler) + " is not available.");
+    }
+    if (m_pickCount[teamIndex(m_turn)] >= TEAM_SIZE) {
+        throw std::logic_error("Illegal move: Team already has 3 picks.");
     }
 
-    // Create copies for the new state
-    QVector<QString> nextTeam1 = m_team1Picks;
-    QVector<QString> nextTeam2 = m_team2Picks;
-    QSet<QString> nextBans = m_bans; // Bans don't change on a pick
-    int nextPickNumber = m_pickNumber + 1;
-    QString nextTurn = m_turn; // Will be updated based on pick number
+    DraftState next = *this;
+    next.push(brawler);
+    return next;
+}
 
-    // Add the pick to the correct team
-    if (m_turn == "team1") {
-        if (nextTeam1.size() >= 3) throw std::logic_error("Illegal move: Team 1 already has 3 picks.");
-        nextTeam1.append(brawler);
-    } else if (m_turn == "team2") {
-         if (nextTeam2.size() >= 3) throw std::logic_error("Illegal move: Team 2 already has 3 picks.");
-        nextTeam2.append(brawler);
-    } else {
-         throw std::logic_error("Illegal move: Invalid turn '" + m_turn.toStdString() + "'.");
-    }
+void DraftState::push(BrawlerId brawler) {
+    Q_ASSERT(!isComplete() && m_available.test(brawler));
+    const int t = teamIndex(m_turn);
+    m_available.reset(brawler);
+    m_picks[t][m_pickCount[t]++] = static_cast<quint8>(brawler);
+    m_hash ^= pickKey(t, brawler);
+    m_pickNumber++;
+    m_turn = turnForPick(m_pickNumber);
+}
 
-    // Determine the next turn based on standard draft order (1-2-2-1-1-?)
-    // Pick 1 (by T1) -> T2's turn (Pick 2)
-    // Pick 2 (by T2) -> T2's turn (Pick 3)
-    // Pick 3 (by T2) -> T1's turn (Pick 4)
-    // Pick 4 (by T1) -> T1's turn (Pick 5)
-    // Pick 5 (by T1) -> T2's turn (Pick 6)
-    // Pick 6 (by T2) -> Complete (Turn becomes empty/null, Pick 7)
-    switch (m_pickNumber) {
-        case 1: nextTurn = "team2"; break;
-        case 2: nextTurn = "team2"; break; // Stays T2 for pick 3
-        case 3: nextTurn = "team1"; break;
-        case 4: nextTurn = "team1"; break; // Stays T1 for pick 5
-        case 5: nextTurn = "team2"; break;
-        case 6: nextTurn = ""; break;      // Draft complete after pick 6
-        default:
-             qWarning() << "Unexpected pick number in applyMove:" << m_pickNumber;
-             nextTurn = ""; // Treat as complete
-             break;
+
+DraftState DraftState::applyBan(BrawlerId brawler) const {
+    // Bans can happen at any point before the draft completes; they don't
+    // advance the pick number or change the turn
+    if (m_banCount >= MAX_BANS) {
+        throw std::logic_error("Illegal ban: Maximum number of bans (6) already reached.");
+    }
+    if (!m_available.test(brawler)) { // Can only ban available brawlers
+        throw std::invalid_argument("Illegal ban: Brawler " + std::to_string(brawler) + " is not available for banning.");
     }
 
-    // Create and return the new state
-    return DraftState(m_map, m_mode, m_masterBrawlerList, nextBans, nextTeam1, nextTeam2, nextTurn, nextPickNumber);
+    DraftState next = *this;
+    next.m_available.reset(brawler);
+    next.m_bans.set(brawler);
+    next.m_banCount++;
+    next.m_hash ^= banKey(brawler);
+    return next;
 }
 
+DraftState DraftState::removeBan(BrawlerId brawler) const {
+    if (!m_bans.test(brawler)) {
+        throw std::invalid_argument("Brawler " + std::to_string(brawler) + " is not banned.");
+    }
+    DraftState next = *this;
+    next.m_bans.reset(brawler);
+    next.m_available.set(brawler);
+    next.m_banCount--;
+    next.m_hash ^= banKey(brawler);
+    return next;
+}
 
-DraftState DraftState::applyBan(const QString& brawler) const {
-     // Bans usually happen before picks, this assumes banning is allowed during the picking phase if needed
-     // Or that this state represents a pre-pick ban phase. Modify logic if bans are fixed upfront.
-    if (m_bans.size() >= 6) {
-         throw std::logic_error("Illegal ban: Maximum number of bans (6) already reached.");
+DraftState DraftState::undoLastPick() const {
+    if (m_pickNumber <= 1) {
+        throw std::logic_error("No pick to undo.");
+    }
+    if (m_pickCount[teamIndex(turnForPick(m_pickNumber - 1))] == 0) {
+        throw std::logic_error("Inconsistent draft: the team that made the last pick has no picks.");
     }
-     if (!m_available.contains(brawler)) { // Can only ban available brawlers
-         throw std::invalid_argument("Illegal ban: Brawler '" + brawler.toStdString() + "' is not available for banning.");
-     }
 
-    QSet<QString> nextBans = m_bans;
-    nextBans.insert(brawler);
+    DraftState next = *this;
+    next.pop();
+    return next;
+}
 
-    // Ban does not advance pick number or change turn in this model
-    return DraftState(m_map, m_mode, m_masterBrawlerList, nextBans, m_team1Picks, m_team2Picks, m_turn, m_pickNumber);
+void DraftState::pop() {
+    Q_ASSERT(m_pickNumber > 1);
+    // Whoever made the previous pick gets the turn back
+    const Turn previousTurn = turnForPick(m_pickNumber - 1);
+    const int t = teamIndex(previousTurn);
+    Q_ASSERT(m_pickCount[t] > 0);
+    BrawlerId brawler = m_picks[t][--m_pickCount[t]];
+    m_picks[t][m_pickCount[t]] = 0;
+    m_available.set(brawler);
+    m_hash ^= pickKey(t, brawler);
+    m_pickNumber--;
+    m_turn = previousTurn;
 }
 
 
-QVector<QString> DraftState::getLegalMoves() const {
+QVector<BrawlerId> DraftState::getLegalMoveIds() const {
     if (isComplete()) {
-        return {}; // No moves if complete
+        return {};
     }
-    // Legal moves are simply the currently available brawlers
-    QVector<QString> legal = QVector<QString>::fromList(m_available.values()); // Convert QSet to QVector
-    std::sort(legal.begin(), legal.end()); // Sort alphabetically for consistency
-    return legal;
+    QVector<BrawlerId> legal;
+    legal.reserve(m_available.count());
+    m_available.forEach([&legal](BrawlerId id) { legal.append(id); });
+    return legal; // Ascending IDs, which is alphabetical order
 }
 
 
-QString DraftState::toString() const {
-    QString t1Str = m_team1Picks.join(", ");
-    QString t2Str = m_team2Picks.join(", ");
-    QList<QString> banList = m_bans.values(); // Get list from set
-    std::sort(banList.begin(), banList.end()); // Sort for consistent output
-    QString banStr = QStringList(banList).join(", "); // Use QStringList helper
+QString DraftState::toString(const BrawlerRegistry& registry) const {
+    auto names = [&registry](const QVector<BrawlerId>& ids) {
+        QStringList list;
+        for (BrawlerId id : ids) list.append(registry.isValid(id) ? registry.nameOf(id) : QString::number(id));
+        return list.join(", ");
+    };
+    QVector<BrawlerId> banIds;
+    m_bans.forEach([&banIds](BrawlerId id) { banIds.append(id); }); // Ascending = sorted by name
 
-    return QString("DraftState(Map: %1, Mode: %2, T1: [%3], T2: [%4], Bans: {%5}, Turn: %6, Pick: %7, Avail: %8)")
-        .arg(m_map).arg(m_mode).arg(t1Str).arg(t2Str).arg(banStr)
-        .arg(m_turn.isEmpty() ? "Complete" : m_turn)
+    return QString("DraftState(MapMode: %1, T1: [%2], T2: [%3], Bans: {%4}, Turn: %5, Pick: %6, Avail: %7)")
+        .arg(m_mapModeId).arg(names(teamPicks(Turn::Team1))).arg(names(teamPicks(Turn::Team2)))
+        .arg(names(banIds))
+        .arg(isComplete() ? QStringLiteral("Complete") : turnName(m_turn))
         .arg(m_pickNumber)
-        .arg(m_available.size());
+        .arg(m_available.count());
 }
 
 
-void DraftState::updateAvailable() {
-    m_available = m_masterBrawlerList;
-    m_available -= m_bans; // Remove banned brawlers
-    for (const auto& p : m_team1Picks) m_available.remove(p);
-    for (const auto& p : m_team2Picks) m_available.remove(p);
+bool DraftState::operator==(const DraftState& other) const {
+    if (m_hash != other.m_hash || m_mapModeId != other.m_mapModeId || m_pickNumber != other.m_pickNumber ||
+        m_banCount != other.m_banCount) {
+        return false;
+    }
+    for (int i = 0; i < BrawlerMask::CAPACITY / 64; ++i) {
+        if (m_available.words[i] != other.m_available.words[i] || m_bans.words[i] != other.m_bans.words[i]) return false;
+    }
+    // Same picks per team in any order (at most 3 each)
+    for (int t = 0; t < 2; ++t) {
+        if (m_pickCount[t] != other.m_pickCount[t]) return false;
+        for (int i = 0; i < m_pickCount[t]; ++i) {
+            const quint8* begin = other.m_picks[t];
+            if (std::find(begin, begin + other.m_pickCount[t], m_picks[t][i]) == begin + other.m_pickCount[t]) return false;
+        }
+    }
+    return true;
 }
-
-// uint qHash(const DraftState &key, uint seed) {
-//     // Implement hashing if needed for QHash keys
-//     // Combine hashes of members like map, mode, picks, bans, turn, pickNumber
-//     // Example: return qHash(key.mapName(), seed) ^ qHash(...) ...;
-//     return 0; // Placeholder
-// }
\ No newline at end of file
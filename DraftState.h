@@ -3,61 +3,137 @@
 
 #include <QString>
 #include <QVector>
-#include <QSet>
-#include <QSharedPointer> // For potential use if state needs shared ownership
 #include <QMetaType>
+#include <QtAlgorithms> // For qPopulationCount, qCountTrailingZeroBits
+#include <type_traits>
 
-#include "DataStructures.h" // Not directly needed, but good practice
+#include "BrawlerRegistry.h"
 
+// Fixed-size set of BrawlerIds (one bit each), so draft states need no heap
+struct BrawlerMask {
+    static constexpr int CAPACITY = 256;
+    quint64 words[CAPACITY / 64] = {};
+
+    bool test(BrawlerId id) const { return id < CAPACITY && (words[id >> 6] >> (id & 63)) & 1u; }
+    void set(BrawlerId id) { words[id >> 6] |= quint64(1) << (id & 63); }
+    void reset(BrawlerId id) { words[id >> 6] &= ~(quint64(1) << (id & 63)); }
+    bool isEmpty() const {
+        for (quint64 w : words) if (w) return false;
+        return true;
+    }
+    int count() const {
+        int total = 0;
+        for (quint64 w : words) total += qPopulationCount(w);
+        return total;
+    }
+    bool intersects(const BrawlerMask& other) const {
+        for (int i = 0; i < CAPACITY / 64; ++i) if (words[i] & other.words[i]) return true;
+        return false;
+    }
+    // The n-th set bit in ascending order (INVALID_BRAWLER_ID if n >= count())
+    BrawlerId nth(int n) const;
+    // Calls f(id) for every set bit, ascending
+    template <typename F>
+    void forEach(F f) const {
+        for (int i = 0; i < CAPACITY / 64; ++i) {
+            for (quint64 w = words[i]; w; w &= w - 1) {
+                f(static_cast<BrawlerId>(i * 64 + qCountTrailingZeroBits(w)));
+            }
+        }
+    }
+};
+
+// One draft position as a small value type: brawlers are BrawlerIds of the
+// StatsView's registry and the map/mode is a StatsView::mapModeId, so copying
+// a state (MCTS nodes, rollouts, queued signals) is a plain memcpy. Names are
+// only resolved at the UI/log boundary.
+//
+// Pick order 1-2-2-1-1-2: team 1 makes pick 1, team 2 picks 2-3, team 1 picks
+// 4-5 and team 2 pick 6. Bans don't advance the pick number.
+//
+// Every state carries a Zobrist hash of its position (map/mode, bans and each
+// team's picks as a set), updated with an XOR per move. States that differ only
+// in the order a team made its picks hash equal and compare equal, which is
+// what lets MCTS merge them (see MCTSTranspositionTable).
 class DraftState {
 public:
-    // Constructor
-    DraftState(QString map, QString mode, const QSet<QString>& allBrawlers,
-               QSet<QString> bans = {},
-               QVector<QString> team1Picks = {},
-               QVector<QString> team2Picks = {},
-               QString turn = "team1",
-               int pickNumber = 1);
-
-    // State properties
-    QString mapName() const;
-    QString modeName() const;
-    const QSet<QString>& bans() const;
-    const QVector<QString>& team1Picks() const;
-    const QVector<QString>& team2Picks() const;
-    QString currentTurn() const;
-    int currentPickNumber() const;
-    const QSet<QString>& availableBrawlers() const; // Brawlers not picked or banned
+    static constexpr int MAX_BRAWLERS = BrawlerMask::CAPACITY; // Higher IDs can't be drafted
+    static constexpr int TEAM_SIZE = 3;
+    static constexpr int TOTAL_PICKS = 2 * TEAM_SIZE;
+    static constexpr int MAX_BANS = 6;
+
+    enum class Turn : quint8 { Team1, Team2, Complete };
+
+    DraftState() = default; // Empty draft (no brawlers), needed by the meta type system
+    // Fresh draft with brawlers 0..brawlerCount-1 available
+    DraftState(int mapModeId, int brawlerCount);
+
+    int mapModeId() const { return m_mapModeId; }
+    Turn currentTurn() const { return m_turn; }
+    int currentPickNumber() const { return m_pickNumber; } // 1-based index of the pick *about* to be made
+    const BrawlerMask& bans() const { return m_bans; }
+    const BrawlerMask& available() const { return m_available; } // Not picked or banned
+    bool isAvailable(BrawlerId id) const { return m_available.test(id); }
+    int banCount() const { return m_banCount; }
+    quint64 hash() const { return m_hash; }
+
+    // A team's picks in pick order
+    int pickCount(Turn team) const { return m_pickCount[teamIndex(team)]; }
+    BrawlerId pick(Turn team, int index) const { return m_picks[teamIndex(team)][index]; }
+    QVector<BrawlerId> teamPicks(Turn team) const;
 
     // State checks
-    bool isComplete() const;
-    bool isValid() const; // Basic check for team sizes etc.
+    bool isComplete() const { return m_turn == Turn::Complete; }
+    bool isValid() const; // Team sizes, ban count, no brawler used twice
+
+    // Actions (return a *new* state); throw on illegal moves
+    DraftState applyMove(BrawlerId brawler) const;
+    DraftState applyBan(BrawlerId brawler) const;
+    DraftState removeBan(BrawlerId brawler) const;
+    DraftState undoLastPick() const; // Back to before the previous pick (pick number > 1)
+
+    // In-place versions for rollouts and tree expansion: push picks 'brawler'
+    // for the team to move, pop takes back the most recent pick. Only checked
+    // with Q_ASSERT (debug builds), so callers pass available brawlers only.
+    void push(BrawlerId brawler);
+    void pop();
 
-    // Actions (return a *new* state)
-    DraftState applyMove(const QString& brawler) const;
-    DraftState applyBan(const QString& brawler) const;
+    // Available brawlers ascending (= alphabetical, see BrawlerRegistry); empty once complete
+    QVector<BrawlerId> getLegalMoveIds() const;
 
-    // Get possible actions
-    QVector<QString> getLegalMoves() const; // Returns available brawlers sorted
+    // Team that makes the given pick (1-6)
+    static Turn turnForPick(int pickNumber);
+    static QString turnName(Turn turn); // "team1", "team2" or "" once complete
 
     // String representation for debugging
-    QString toString() const;
+    QString toString(const BrawlerRegistry& registry) const;
+
+    // Same position: pick order within a team doesn't matter
+    bool operator==(const DraftState& other) const;
+    bool operator!=(const DraftState& other) const { return !(*this == other); }
 
 private:
-    QString m_map;
-    QString m_mode;
-    QSet<QString> m_masterBrawlerList;
-    QSet<QString> m_bans;
-    QVector<QString> m_team1Picks;
-    QVector<QString> m_team2Picks;
-    QString m_turn; // "team1", "team2", or "" (empty/null if complete)
-    int m_pickNumber; // 1-based index of the pick *about* to be made
-    QSet<QString> m_available;
-
-    void updateAvailable(); // Helper to recalculate available brawlers
+    static int teamIndex(Turn team) { return team == Turn::Team2 ? 1 : 0; }
+    // Random keys XOR-ed into m_hash, one per (team pick | ban, brawler)
+    static quint64 pickKey(int team, BrawlerId brawler);
+    static quint64 banKey(BrawlerId brawler);
+
+    BrawlerMask m_available;
+    BrawlerMask m_bans;
+    quint8 m_picks[2][TEAM_SIZE] = {};
+    quint8 m_pickCount[2] = {};
+    quint8 m_banCount = 0;
+    quint8 m_pickNumber = 1;
+    Turn m_turn = Turn::Team1;
+    qint32 m_mapModeId = -1;
+    quint64 m_hash = 0;
 };
 
-// Define QHash hash function for DraftState if you need to use it as a key
-// uint qHash(const DraftState &key, uint seed = 0);
+inline size_t qHash(const DraftState& key, size_t seed = 0) {
+    return size_t(key.hash()) ^ seed;
+}
+
+static_assert(std::is_trivially_copyable<DraftState>::value, "DraftState is copied by value into MCTS nodes and rollouts");
+Q_DECLARE_METATYPE(DraftState)
 
-#endif // DRAFTSTATE_H
\ No newline at end of file
+#endif // DRAFTSTATE_H
@@ -0,0 +1,333 @@
+#include "GameTable.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm> // For std::clamp
+#include <cstring>   // For std::memcpy
+#include <limits>
+
+namespace {
+    constexpr quint16 INVALID_NAME_ID = std::numeric_limits<quint16>::max();
+    constexpr qint64 SECTION_ALIGNMENT = 64;
+
+    qint64 align(qint64 offset) { return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1); }
+}
+
+void GameTable::reserve(qsizetype games) {
+    detach();
+    m_mapIds.reserve(games);
+    m_modeIds.reserve(games);
+    m_brawlerIds.reserve(games * PLAYERS_PER_GAME);
+    m_ranks.reserve(games * PLAYERS_PER_GAME);
+}
+
+void GameTable::clear() {
+    *this = GameTable();
+}
+
+void GameTable::detach() {
+    if (!m_mapped) return;
+    std::shared_ptr<const Mapping> mapped = std::move(m_mapped);
+    const qsizetype games = mapped->gameCount;
+    m_mapIds = QVector<quint16>(mapped->mapIds, mapped->mapIds + games);
+    m_modeIds = QVector<quint16>(mapped->modeIds, mapped->modeIds + games);
+    m_brawlerIds = QVector<BrawlerId>(mapped->brawlerIds, mapped->brawlerIds + games * PLAYERS_PER_GAME);
+    m_ranks = QVector<quint8>(mapped->ranks, mapped->ranks + games * PLAYERS_PER_GAME);
+}
+
+quint16 GameTable::intern(QVector<QString>& names, QHash<QString, quint16>& ids, const QString& name) {
+    auto it = ids.constFind(name);
+    if (it != ids.constEnd()) return it.value();
+    if (names.size() >= INVALID_NAME_ID) return INVALID_NAME_ID;
+    quint16 id = static_cast<quint16>(names.size());
+    names.append(name);
+    ids.insert(name, id);
+    return id;
+}
+
+bool GameTable::append(const ProcessedGame& game) {
+    if (game.winningTeamData.size() != TEAM_SIZE || game.losingTeamData.size() != TEAM_SIZE) {
+        return false;
+    }
+    detach();
+
+    // Resolve everything first so a failure leaves the columns untouched
+    BrawlerId players[PLAYERS_PER_GAME];
+    quint8 ranks[PLAYERS_PER_GAME];
+    for (int i = 0; i < PLAYERS_PER_GAME; ++i) {
+        const PlayerData& p = (i < TEAM_SIZE) ? game.winningTeamData[i] : game.losingTeamData[i - TEAM_SIZE];
+        players[i] = m_brawlers.add(p.brawlerName);
+        ranks[i] = static_cast<quint8>(std::clamp(p.rank, 0, MAX_STORED_RANK));
+        if (players[i] == INVALID_BRAWLER_ID) return false;
+    }
+    quint16 mapId = intern(m_mapNames, m_mapIdsByName, game.map);
+    quint16 modeId = intern(m_modeNames, m_modeIdsByName, game.mode);
+    if (mapId == INVALID_NAME_ID || modeId == INVALID_NAME_ID) {
+        qWarning() << "Game table has too many distinct maps/modes, dropping game on" << game.map << game.mode;
+        return false;
+    }
+
+    m_mapIds.append(mapId);
+    m_modeIds.append(modeId);
+    for (int i = 0; i < PLAYERS_PER_GAME; ++i) {
+        m_brawlerIds.append(players[i]);
+        m_ranks.append(ranks[i]);
+    }
+    return true;
+}
+
+void GameTable::appendTable(const GameTable& other) {
+    detach(); // Even if nothing is added, so the caller can replace the mapped file
+    if (other.isEmpty()) return;
+
+    // Other table's IDs -> ours, interning names we haven't seen
+    QVector<quint16> mapIds(other.m_mapNames.size());
+    for (int i = 0; i < mapIds.size(); ++i) mapIds[i] = intern(m_mapNames, m_mapIdsByName, other.m_mapNames[i]);
+    QVector<quint16> modeIds(other.m_modeNames.size());
+    for (int i = 0; i < modeIds.size(); ++i) modeIds[i] = intern(m_modeNames, m_modeIdsByName, other.m_modeNames[i]);
+    QVector<BrawlerId> brawlerIds(other.m_brawlers.size());
+    for (int i = 0; i < brawlerIds.size(); ++i) brawlerIds[i] = m_brawlers.add(other.m_brawlers.nameOf(static_cast<BrawlerId>(i)));
+
+    const quint16* otherMapIds = other.mapIds();
+    const quint16* otherModeIds = other.modeIds();
+    const BrawlerId* otherBrawlerIds = other.brawlerIds();
+    const quint8* otherRanks = other.ranks();
+    reserve(size() + other.size());
+    int dropped = 0;
+    for (qsizetype g = 0; g < other.size(); ++g) {
+        const quint16 mapId = mapIds[otherMapIds[g]];
+        const quint16 modeId = modeIds[otherModeIds[g]];
+        const qsizetype row = g * PLAYERS_PER_GAME;
+        bool valid = mapId != INVALID_NAME_ID && modeId != INVALID_NAME_ID;
+        for (int i = 0; i < PLAYERS_PER_GAME && valid; ++i) {
+            valid = brawlerIds[otherBrawlerIds[row + i]] != INVALID_BRAWLER_ID;
+        }
+        if (!valid) { dropped++; continue; }
+
+        m_mapIds.append(mapId);
+        m_modeIds.append(modeId);
+        for (int i = 0; i < PLAYERS_PER_GAME; ++i) {
+            m_brawlerIds.append(brawlerIds[otherBrawlerIds[row + i]]);
+            m_ranks.append(otherRanks[row + i]);
+        }
+    }
+    if (dropped > 0) qWarning() << "Dropped" << dropped << "games while merging game tables (name tables full).";
+}
+
+ProcessedGame GameTable::game(qsizetype index) const {
+    ProcessedGame game;
+    game.map = m_mapNames.at(mapIds()[index]);
+    game.mode = m_modeNames.at(modeIds()[index]);
+    const qsizetype row = index * PLAYERS_PER_GAME;
+    for (int i = 0; i < PLAYERS_PER_GAME; ++i) {
+        PlayerData p{m_brawlers.nameOf(brawlerIds()[row + i]), ranks()[row + i]};
+        (i < TEAM_SIZE ? game.winningTeamData : game.losingTeamData).append(p);
+    }
+    return game;
+}
+
+
+// --- games.bin ---
+
+// FNV-1a style over 8-byte words (then the tail), fast enough to check on every load
+quint64 GameTable::checksum(const char* data, qint64 size) {
+    constexpr quint64 PRIME = 0x100000001b3ULL;
+    quint64 h = 0xcbf29ce484222325ULL;
+    qint64 i = 0;
+    for (; i + 8 <= size; i += 8) {
+        quint64 word;
+        std::memcpy(&word, data + i, sizeof(word));
+        h = (h ^ word) * PRIME;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * PRIME;
+    }
+    return h;
+}
+
+bool GameTable::writeFile(const QString& filepath, quint64 ingestStamp) const {
+    // Strings: maps, then modes, then brawlers (index order = ID order)
+    QVector<QByteArray> strings;
+    for (const QString& s : m_mapNames) strings.append(s.toUtf8());
+    for (const QString& s : m_modeNames) strings.append(s.toUtf8());
+    for (const QString& s : m_brawlers.names()) strings.append(s.toUtf8());
+    qint64 stringBytes = 0;
+    for (const QByteArray& s : strings) stringBytes += s.size();
+
+    const qint64 games = size();
+    const qint64 stringIndexOffset = align(sizeof(FileHeader));
+    const qint64 stringDataOffset = stringIndexOffset + qint64(strings.size()) * qint64(sizeof(StringRef));
+    const qint64 mapIdsOffset = align(stringDataOffset + stringBytes);
+    const qint64 modeIdsOffset = align(mapIdsOffset + games * qint64(sizeof(quint16)));
+    const qint64 brawlerIdsOffset = align(modeIdsOffset + games * qint64(sizeof(quint16)));
+    const qint64 ranksOffset = align(brawlerIdsOffset + games * PLAYERS_PER_GAME * qint64(sizeof(BrawlerId)));
+    const qint64 fileSize = align(ranksOffset + games * PLAYERS_PER_GAME);
+
+    AlignedVector<char> image(static_cast<size_t>(fileSize), 0);
+    char* base = image.data();
+    StringRef* stringIndex = reinterpret_cast<StringRef*>(base + stringIndexOffset);
+    quint32 stringPos = 0;
+    for (int i = 0; i < strings.size(); ++i) {
+        stringIndex[i] = {stringPos, static_cast<quint32>(strings[i].size())};
+        std::memcpy(base + stringDataOffset + stringPos, strings[i].constData(), static_cast<size_t>(strings[i].size()));
+        stringPos += static_cast<quint32>(strings[i].size());
+    }
+    std::memcpy(base + mapIdsOffset, mapIds(), static_cast<size_t>(games) * sizeof(quint16));
+    std::memcpy(base + modeIdsOffset, modeIds(), static_cast<size_t>(games) * sizeof(quint16));
+    std::memcpy(base + brawlerIdsOffset, brawlerIds(), static_cast<size_t>(games) * PLAYERS_PER_GAME * sizeof(BrawlerId));
+    std::memcpy(base + ranksOffset, ranks(), static_cast<size_t>(games) * PLAYERS_PER_GAME);
+
+    FileHeader& header = *reinterpret_cast<FileHeader*>(base);
+    header = FileHeader{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.fileSize = static_cast<quint64>(fileSize);
+    header.ingestStamp = ingestStamp;
+    header.gameCount = static_cast<quint64>(games);
+    header.mapCount = static_cast<quint32>(m_mapNames.size());
+    header.modeCount = static_cast<quint32>(m_modeNames.size());
+    header.brawlerCount = static_cast<quint32>(m_brawlers.size());
+    header.stringIndexOffset = stringIndexOffset;
+    header.stringDataOffset = stringDataOffset;
+    header.mapIdsOffset = mapIdsOffset;
+    header.modeIdsOffset = modeIdsOffset;
+    header.brawlerIdsOffset = brawlerIdsOffset;
+    header.ranksOffset = ranksOffset;
+    header.checksum = checksum(base + sizeof(FileHeader), fileSize - qint64(sizeof(FileHeader)));
+
+    QDir dir = QFileInfo(filepath).dir();
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qCritical() << "Failed to create games file directory:" << dir.path();
+        return false;
+    }
+    const QString tempPath = filepath + ".tmp";
+    QFile file(tempPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << "Error opening games file for writing:" << tempPath << file.errorString();
+        return false;
+    }
+    qint64 written = file.write(base, fileSize);
+    file.close();
+    if (written != fileSize) {
+        qCritical() << "Error writing games file:" << tempPath;
+        QFile::remove(tempPath);
+        return false;
+    }
+    if (QFile::exists(filepath) && !QFile::remove(filepath)) {
+        qCritical() << "Could not replace existing games file:" << filepath;
+        QFile::remove(tempPath);
+        return false;
+    }
+    if (!QFile::rename(tempPath, filepath)) {
+        qCritical() << "Failed to move games file into place:" << filepath;
+        return false;
+    }
+    qInfo() << "Saved" << games << "games to" << filepath << "(" << fileSize << "bytes)";
+    return true;
+}
+
+GameTable::Mapping::~Mapping() {
+    if (file && data) {
+        file->unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+    }
+}
+
+std::optional<GameTable> GameTable::mapFile(const QString& filepath, quint64 ingestStamp) {
+    auto file = std::make_unique<QFile>(filepath);
+    if (!file->exists()) {
+        qInfo() << "Games file not found:" << filepath;
+        return std::nullopt;
+    }
+    if (!file->open(QIODevice::ReadOnly)) {
+        qWarning() << "Error opening games file for reading:" << filepath << file->errorString();
+        return std::nullopt;
+    }
+    const qint64 fileSize = file->size();
+    if (fileSize < qint64(sizeof(FileHeader))) {
+        qWarning() << "Games file too small to hold a header:" << filepath;
+        return std::nullopt;
+    }
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->data = reinterpret_cast<const char*>(file->map(0, fileSize));
+    if (!mapping->data) {
+        qWarning() << "Failed to memory-map games file:" << filepath << file->errorString();
+        return std::nullopt;
+    }
+    mapping->file = std::move(file);
+    const char* base = mapping->data;
+    const FileHeader& h = *reinterpret_cast<const FileHeader*>(base);
+
+    if (h.magic != FILE_MAGIC || h.version != FILE_VERSION) {
+        qWarning() << "Games file has the wrong format or version (expected" << FILE_VERSION << "):" << filepath;
+        return std::nullopt;
+    }
+    if (h.ingestStamp != ingestStamp) {
+        qInfo() << "Games file belongs to a different stats pack, ignoring it:" << filepath;
+        return std::nullopt;
+    }
+
+    // Bounds first, then the checksum, then every ID (the aggregation indexes with them unchecked)
+    const quint64 size = static_cast<quint64>(fileSize);
+    auto inFile = [size](quint64 offset, quint64 bytes) { return offset <= size && bytes <= size - offset; };
+    const quint64 games = h.gameCount;
+    const quint64 stringCount = quint64(h.mapCount) + h.modeCount + h.brawlerCount;
+    if (h.fileSize != size || games > size ||
+        h.mapCount > INVALID_NAME_ID || h.modeCount > INVALID_NAME_ID || h.brawlerCount >= INVALID_BRAWLER_ID ||
+        !inFile(h.stringIndexOffset, stringCount * sizeof(StringRef)) ||
+        !inFile(h.mapIdsOffset, games * sizeof(quint16)) ||
+        !inFile(h.modeIdsOffset, games * sizeof(quint16)) ||
+        !inFile(h.brawlerIdsOffset, games * PLAYERS_PER_GAME * sizeof(BrawlerId)) ||
+        !inFile(h.ranksOffset, games * PLAYERS_PER_GAME) ||
+        h.stringIndexOffset % alignof(StringRef) != 0 || h.mapIdsOffset % alignof(quint16) != 0 ||
+        h.modeIdsOffset % alignof(quint16) != 0 || h.brawlerIdsOffset % alignof(BrawlerId) != 0)
+    {
+        qWarning() << "Games file has an invalid layout (truncated?):" << filepath;
+        return std::nullopt;
+    }
+    if (checksum(base + sizeof(FileHeader), fileSize - qint64(sizeof(FileHeader))) != h.checksum) {
+        qWarning() << "Games file checksum mismatch (corrupt?):" << filepath;
+        return std::nullopt;
+    }
+
+    GameTable table;
+    const StringRef* strings = reinterpret_cast<const StringRef*>(base + h.stringIndexOffset);
+    QVector<QString> brawlerNames;
+    for (quint64 i = 0; i < stringCount; ++i) {
+        if (!inFile(h.stringDataOffset + strings[i].offset, strings[i].length)) {
+            qWarning() << "Games file string" << i << "out of bounds:" << filepath;
+            return std::nullopt;
+        }
+        QString name = QString::fromUtf8(base + h.stringDataOffset + strings[i].offset, static_cast<qsizetype>(strings[i].length));
+        if (i < h.mapCount) intern(table.m_mapNames, table.m_mapIdsByName, name);
+        else if (i < quint64(h.mapCount) + h.modeCount) intern(table.m_modeNames, table.m_modeIdsByName, name);
+        else brawlerNames.append(name);
+    }
+    table.m_brawlers = BrawlerRegistry(brawlerNames);
+    if (table.m_mapNames.size() != qsizetype(h.mapCount) || table.m_modeNames.size() != qsizetype(h.modeCount) ||
+        table.m_brawlers.size() != int(h.brawlerCount))
+    {
+        qWarning() << "Games file has duplicate names:" << filepath;
+        return std::nullopt;
+    }
+
+    mapping->gameCount = static_cast<qsizetype>(games);
+    mapping->mapIds = reinterpret_cast<const quint16*>(base + h.mapIdsOffset);
+    mapping->modeIds = reinterpret_cast<const quint16*>(base + h.modeIdsOffset);
+    mapping->brawlerIds = reinterpret_cast<const BrawlerId*>(base + h.brawlerIdsOffset);
+    mapping->ranks = reinterpret_cast<const quint8*>(base + h.ranksOffset);
+    for (quint64 g = 0; g < games; ++g) {
+        bool valid = mapping->mapIds[g] < h.mapCount && mapping->modeIds[g] < h.modeCount;
+        for (int i = 0; i < PLAYERS_PER_GAME; ++i) {
+            valid = valid && mapping->brawlerIds[g * PLAYERS_PER_GAME + i] < h.brawlerCount;
+        }
+        if (!valid) {
+            qWarning() << "Games file has an out of range ID in game" << g << ":" << filepath;
+            return std::nullopt;
+        }
+    }
+
+    table.m_mapped = std::move(mapping);
+    qInfo() << "Mapped" << games << "games from" << filepath;
+    return table;
+}
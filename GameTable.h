@@ -0,0 +1,120 @@
+#ifndef GAMETABLE_H
+#define GAMETABLE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <memory>
+#include <optional>
+#include "DataStructures.h"
+#include "BrawlerRegistry.h"
+
+// Columnar store of processed games: a few contiguous arrays instead of two
+// QStrings and six PlayerData (each with its own QString) per game, about 22
+// bytes a game. Map, mode and brawler names are interned to 16-bit IDs in
+// first-seen order (the IDs are local to the table; StatsBuilder maps them by name).
+//
+// Players are stored winners first: slots 0-2 won, 3-5 lost, so the outcome is
+// implied by the position. Aggregation scans the columns front to back
+// (StatsBuilder::calculateStats).
+//
+// The table can be saved as games.bin and mapped back; the columns are then
+// read in place until the table is modified (append copies them out first).
+class GameTable {
+public:
+    static constexpr int TEAM_SIZE = 3;
+    static constexpr int PLAYERS_PER_GAME = 2 * TEAM_SIZE;
+    static constexpr int MAX_STORED_RANK = 255; // Higher ranks are clamped (weights cap far below)
+
+    // games.bin layout (native endianness, sections 64-byte aligned):
+    //   FileHeader, StringRef[mapCount + modeCount + brawlerCount], string data,
+    //   mapIds[gameCount], modeIds[gameCount] (quint16),
+    //   brawlerIds[gameCount * 6] (BrawlerId), ranks[gameCount * 6] (quint8)
+    static constexpr quint32 FILE_MAGIC = 0x534D4747; // "GGMS"
+    static constexpr quint32 FILE_VERSION = 1;
+
+    struct FileHeader {
+        quint32 magic;
+        quint32 version;
+        quint64 fileSize;
+        quint64 checksum;      // Of every byte after the header
+        quint64 ingestStamp;   // ingestStamp() of the stats.pack built from these games
+        quint64 gameCount;
+        quint32 mapCount;
+        quint32 modeCount;
+        quint32 brawlerCount;
+        quint32 reserved;
+        quint64 stringIndexOffset;
+        quint64 stringDataOffset;
+        quint64 mapIdsOffset;
+        quint64 modeIdsOffset;
+        quint64 brawlerIdsOffset;
+        quint64 ranksOffset;
+    };
+    struct StringRef {
+        quint32 offset; // Relative to stringDataOffset
+        quint32 length; // UTF-8 bytes
+    };
+
+    qsizetype size() const { return m_mapped ? m_mapped->gameCount : m_mapIds.size(); }
+    bool isEmpty() const { return size() == 0; }
+    void reserve(qsizetype games);
+    void clear();
+
+    // Interns the names and adds one row. Returns false (nothing added) if a
+    // team doesn't have exactly 3 players or a name table is full.
+    bool append(const ProcessedGame& game);
+    // Adds every row of 'other' after this table's rows, remapping IDs by name
+    void appendTable(const GameTable& other);
+
+    // Columns, one entry per game (brawler/rank: PLAYERS_PER_GAME per game)
+    const quint16* mapIds() const { return m_mapped ? m_mapped->mapIds : m_mapIds.constData(); }
+    const quint16* modeIds() const { return m_mapped ? m_mapped->modeIds : m_modeIds.constData(); }
+    const BrawlerId* brawlerIds() const { return m_mapped ? m_mapped->brawlerIds : m_brawlerIds.constData(); }
+    const quint8* ranks() const { return m_mapped ? m_mapped->ranks : m_ranks.constData(); }
+
+    const QVector<QString>& mapNames() const { return m_mapNames; }
+    const QVector<QString>& modeNames() const { return m_modeNames; }
+    const BrawlerRegistry& brawlers() const { return m_brawlers; }
+
+    ProcessedGame game(qsizetype index) const; // Row back as names (debugging / tools)
+
+    // Writes games.bin via a temp file + rename. 'ingestStamp' (see
+    // DataStructures.h) ties it to the stats.pack holding the same games.
+    bool writeFile(const QString& filepath, quint64 ingestStamp) const;
+    // Maps games.bin read-only after checking the checksum and every ID.
+    // nullopt if missing, corrupt, or written for a different pack.
+    static std::optional<GameTable> mapFile(const QString& filepath, quint64 ingestStamp);
+
+private:
+    // A mapped games.bin, shared by copies of the table
+    struct Mapping {
+        std::unique_ptr<QFile> file;
+        const char* data = nullptr;
+        qsizetype gameCount = 0;
+        const quint16* mapIds = nullptr;
+        const quint16* modeIds = nullptr;
+        const BrawlerId* brawlerIds = nullptr;
+        const quint8* ranks = nullptr;
+        ~Mapping();
+    };
+
+    static quint16 intern(QVector<QString>& names, QHash<QString, quint16>& ids, const QString& name);
+    static quint64 checksum(const char* data, qint64 size);
+    void detach(); // Copies mapped columns into the owned vectors
+
+    std::shared_ptr<const Mapping> m_mapped; // Set while reading a mapped file in place
+    QVector<quint16> m_mapIds;
+    QVector<quint16> m_modeIds;
+    QVector<BrawlerId> m_brawlerIds; // PLAYERS_PER_GAME per game, winners first
+    QVector<quint8> m_ranks;         // Same layout as m_brawlerIds
+
+    QVector<QString> m_mapNames;
+    QHash<QString, quint16> m_mapIdsByName;
+    QVector<QString> m_modeNames;
+    QHash<QString, quint16> m_modeIdsByName;
+    BrawlerRegistry m_brawlers; // Grown with add(), first-seen order
+};
+
+#endif // GAMETABLE_H
@@ -4,42 +4,44 @@
 #include <limits>
 #include <algorithm> // for std::sort
 
-QPair<QString, QHash<QString, HeuristicScoreComponents>>
-suggestPickHeuristic(const DraftState& draftState,
-                     const StatsCalculator& statsCalculator,
-                     const HeuristicWeights& weights)
+// Calls f(brawler, scores) for every available brawler, ascending IDs
+template <typename F>
+static void
+forEachPickScore(const DraftState& draftState,
+                 const MapModeTables* tables,
+                 const HeuristicWeights& weights,
+                 F f)
 {
-    QVector<QString> legalMoves = draftState.getLegalMoves();
-    if (legalMoves.isEmpty()) {
-        return {"", {}}; // No best pick, empty scores map
-    }
-
-    QString bestBrawler = "";
-    double bestScore = -std::numeric_limits<double>::infinity();
-    QHash<QString, HeuristicScoreComponents> brawlerScores;
-
-    const QVector<QString>& currentTeamPicks = (draftState.currentTurn() == "team1") ? draftState.team1Picks() : draftState.team2Picks();
-    const QVector<QString>& opponentPicks = (draftState.currentTurn() == "team1") ? draftState.team2Picks() : draftState.team1Picks();
+    // Picks so far, read straight from the state's fixed arrays
+    const DraftState::Turn us = draftState.currentTurn();
+    const DraftState::Turn them = (us == DraftState::Turn::Team1) ? DraftState::Turn::Team2 : DraftState::Turn::Team1;
+    BrawlerId currentTeamPicks[DraftState::TEAM_SIZE];
+    BrawlerId opponentPicks[DraftState::TEAM_SIZE];
+    const int teamCount = draftState.pickCount(us);
+    const int opponentCount = draftState.pickCount(them);
+    for (int i = 0; i < teamCount; ++i) currentTeamPicks[i] = draftState.pick(us, i);
+    for (int i = 0; i < opponentCount; ++i) opponentPicks[i] = draftState.pick(them, i);
 
-    for (const QString& brawler : legalMoves) {
+    // Available brawlers in ascending ID order
+    draftState.available().forEach([&](BrawlerId brawler) {
         HeuristicScoreComponents scores;
 
         // --- Win Rate Component ---
-        // Use .value_or with a default (e.g., 0.5 or config default) if optional is nullopt
-        double wr = statsCalculator.getWinRate(brawler, draftState.mapName(), draftState.modeName())
-                .value_or(0.5); // Or a reasonable default if getWinRate itself could fail
+        // Default to 0.5 if there are no stats for this map/mode
+        double wr = tables ? tables->winRate(brawler) : 0.5;
         scores.winRate = wr;
         scores.wrComponent = weights.winRate * (wr - 0.5); // Score relative to 0.5 baseline
 
         // --- Synergy Component ---
         scores.avgSynergy = 0.5; // Default
         scores.synergyComponent = 0.0;
-        if (!currentTeamPicks.isEmpty()) {
+        if (teamCount > 0) {
             double totalSynScoreDiff = 0.0;
             int count = 0;
-            for (const QString& teammate : currentTeamPicks) {
-                // getSynergyScore returns 0.5 if no data
-                double pairWR = statsCalculator.getSynergyScore(brawler, teammate, draftState.mapName(), draftState.modeName());
+            for (int i = 0; i < teamCount; ++i) {
+                BrawlerId teammate = currentTeamPicks[i];
+                // Table holds 0.5 if no data
+                double pairWR = tables ? tables->synergyScore(brawler, teammate) : 0.5;
                 totalSynScoreDiff += (pairWR - 0.5);
                 count++;
             }
@@ -53,12 +55,13 @@ suggestPickHeuristic(const DraftState& draftState,
         // --- Counter Component ---
         scores.avgCounter = 0.5; // Default
         scores.counterComponent = 0.0;
-        if (!opponentPicks.isEmpty()) {
+        if (opponentCount > 0) {
             double totalCtrScoreDiff = 0.0;
             int count = 0;
-            for (const QString& opponent : opponentPicks) {
-                // getCounterScore returns 0.5 if no data
-                double matchupWR = statsCalculator.getCounterScore(brawler, opponent, draftState.mapName(), draftState.modeName());
+            for (int i = 0; i < opponentCount; ++i) {
+                BrawlerId opponent = opponentPicks[i];
+                // Table holds 0.5 if no data
+                double matchupWR = tables ? tables->counterScore(brawler, opponent) : 0.5;
                 totalCtrScoreDiff += (matchupWR - 0.5);
                 count++;
             }
@@ -70,51 +73,120 @@ suggestPickHeuristic(const DraftState& draftState,
         }
 
         // --- Pick Rate Component ---
-        // Use .value_or(0.0) if pick rate is not available
-        double pr = statsCalculator.getPickRate(brawler, draftState.mapName(), draftState.modeName()).value_or(0.0);
+        // Table holds 0.0 if pick rate is not available
+        double pr = tables ? tables->pickRate(brawler) : 0.0;
         scores.pickRate = pr;
         scores.prComponent = weights.pickRate * pr; // Direct contribution from pick rate
 
         // --- Total Score ---
         scores.totalScore = scores.wrComponent + scores.synergyComponent + scores.counterComponent + scores.prComponent;
 
-        brawlerScores.insert(brawler, scores);
+        f(brawler, scores);
+    });
+}
+
+BrawlerId
+bestPickHeuristic(const DraftState& draftState,
+                  const MapModeTables* tables,
+                  const HeuristicWeights& weights,
+                  QHash<BrawlerId, HeuristicScoreComponents>* scoresOut)
+{
+    if (draftState.isComplete()) {
+        return INVALID_BRAWLER_ID; // No best pick
+    }
+
+    BrawlerId bestBrawler = INVALID_BRAWLER_ID;
+    double bestScore = -std::numeric_limits<double>::infinity();
+
+    // Ascending IDs, so ties go to the same brawler as before
+    forEachPickScore(draftState, tables, weights, [&](BrawlerId brawler, const HeuristicScoreComponents& scores) {
+        if (scoresOut) {
+            scoresOut->insert(brawler, scores);
+        }
 
         // Update best score/brawler
         if (scores.totalScore > bestScore) {
             bestScore = scores.totalScore;
             bestBrawler = brawler;
         }
+    });
+
+    return bestBrawler;
+}
+
+void
+scorePicksHeuristic(const DraftState& draftState,
+                    const MapModeTables* tables,
+                    const HeuristicWeights& weights,
+                    double* scoresOut)
+{
+    if (draftState.isComplete()) {
+        return;
+    }
+    forEachPickScore(draftState, tables, weights, [scoresOut](BrawlerId brawler, const HeuristicScoreComponents& scores) {
+        scoresOut[brawler] = scores.totalScore;
+    });
+}
+
+BrawlerId
+bestPickHeuristic(const DraftState& draftState,
+                  const StatsView& statsView,
+                  const HeuristicWeights& weights,
+                  QHash<BrawlerId, HeuristicScoreComponents>* scoresOut)
+{
+    StatsView::TablesHandle tables = statsView.getMapModeTables(draftState.mapModeId());
+    return bestPickHeuristic(draftState, tables.get(), weights, scoresOut);
+}
+
+
+QPair<QString, QHash<QString, HeuristicScoreComponents>>
+suggestPickHeuristic(const DraftState& draftState,
+                     const StatsView& statsView,
+                     const HeuristicWeights& weights)
+{
+    QHash<BrawlerId, HeuristicScoreComponents> idScores;
+    BrawlerId best = bestPickHeuristic(draftState, statsView, weights, &idScores);
+    if (best == INVALID_BRAWLER_ID) {
+        return {"", {}}; // No best pick, empty scores map
+    }
+
+    // Convert IDs back to names for display
+    const BrawlerRegistry& registry = statsView.brawlerRegistry();
+    QHash<QString, HeuristicScoreComponents> brawlerScores;
+    brawlerScores.reserve(idScores.size());
+    for (auto it = idScores.constBegin(); it != idScores.constEnd(); ++it) {
+        brawlerScores.insert(registry.nameOf(it.key()), it.value());
     }
 
     // No need to sort the QHash here, MainWindow can sort the results if needed for display
-    return {bestBrawler, brawlerScores};
+    return {registry.nameOf(best), brawlerScores};
 }
 
 
 QVector<QString>
 suggestBanHeuristic(const DraftState& draftState,
-                    const StatsCalculator& statsCalculator,
+                    const StatsView& statsView,
                     int numSuggestions)
 {
-    QVector<QString> legalMoves = draftState.getLegalMoves();
+    const BrawlerRegistry& registry = statsView.brawlerRegistry();
+    QVector<BrawlerId> legalMoves = draftState.getLegalMoveIds();
     if (legalMoves.isEmpty()) {
         return {};
     }
 
-    QVector<QPair<QString, double>> banCandidates; // Store as pairs for sorting
+    StatsView::TablesHandle tables = statsView.getMapModeTables(draftState.mapModeId());
+    QVector<QPair<BrawlerId, double>> banCandidates; // Store as pairs for sorting
     banCandidates.reserve(legalMoves.size());
 
-    for (const QString& brawler : legalMoves) {
+    for (BrawlerId brawler : legalMoves) {
         // Base ban suggestion purely on adjusted win rate
-        double wr = statsCalculator.getWinRate(brawler, draftState.mapName(), draftState.modeName())
-               .value_or(0.0); // Default to 0 if WR calculation fails entirely
+        double wr = tables ? tables->winRate(brawler) : 0.0; // Default to 0 if there are no stats
         banCandidates.append({brawler, wr});
     }
 
     // Sort candidates by win rate descending
     std::sort(banCandidates.begin(), banCandidates.end(),
-              [](const QPair<QString, double>& a, const QPair<QString, double>& b) {
+              [](const QPair<BrawlerId, double>& a, const QPair<BrawlerId, double>& b) {
                   return a.second > b.second; // Sort descending by score
               });
 
@@ -123,7 +195,7 @@ suggestBanHeuristic(const DraftState& draftState,
     int count = 0;
     for (const auto& candidate : banCandidates) {
         if (count >= numSuggestions) break;
-        suggestions.append(candidate.first);
+        suggestions.append(registry.nameOf(candidate.first));
         count++;
     }
 
@@ -131,42 +203,43 @@ suggestBanHeuristic(const DraftState& draftState,
 }
 
 
-double
-predictWinProbabilityModel(const QVector<QString>& team1Brawlers,
-                           const QVector<QString>& team2Brawlers,
-                           const QString& mapName,
-                           const QString& modeName,
-                           const StatsCalculator& statsCalculator,
-                           const HeuristicWeights& evalWeights) // Use specific eval weights
+// Shared by the predictWinProbabilityModel overloads and evaluateDraftState.
+// Up to 3 brawlers per team; a missing pick contributes nothing, so a complete
+// draft is scored exactly as before and an empty one comes out at 0.5.
+static double
+predictFromTeams(const BrawlerId* team1Brawlers, int team1Count,
+                 const BrawlerId* team2Brawlers, int team2Count,
+                 const MapModeTables* tables,
+                 const HeuristicWeights& evalWeights) // Use specific eval weights
 {
-    if (team1Brawlers.size() != 3 || team2Brawlers.size() != 3) {
-        qWarning() << "predictWinProbabilityModel called with incomplete teams.";
-        return 0.5; // Default for invalid input
+    if (!tables) {
+        return 0.5; // No stats for this map/mode: every component would be neutral
     }
 
     // 1. Average Win Rate Difference
-    double t1AvgWR = 0.0, t2AvgWR = 0.0;
-    for(const auto& b : team1Brawlers) t1AvgWR += statsCalculator.getWinRate(b, mapName, modeName).value_or(0.5);
-    for(const auto& b : team2Brawlers) t2AvgWR += statsCalculator.getWinRate(b, mapName, modeName).value_or(0.5);
-    t1AvgWR /= 3.0;
-    t2AvgWR /= 3.0;
-    double baseWrDiff = t1AvgWR - t2AvgWR;
+    auto calculateAvgWinRate = [&](const BrawlerId* team, int count) {
+        if (count == 0) return 0.5;
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) sum += tables->winRate(team[i]);
+        return sum / count;
+    };
+    double baseWrDiff = calculateAvgWinRate(team1Brawlers, team1Count) - calculateAvgWinRate(team2Brawlers, team2Count);
 
     // 2. Average Synergy Difference
-    auto calculateAvgSynergyDiff = [&](const QVector<QString>& team) {
+    auto calculateAvgSynergyDiff = [&](const BrawlerId* team, int count) {
         double synergySumDiff = 0.0;
         int pairs = 0;
-        for (int i = 0; i < 3; ++i) {
-            for (int j = i + 1; j < 3; ++j) {
-                double synergy = statsCalculator.getSynergyScore(team[i], team[j], mapName, modeName);
+        for (int i = 0; i < count; ++i) {
+            for (int j = i + 1; j < count; ++j) {
+                double synergy = tables->synergyScore(team[i], team[j]);
                 synergySumDiff += (synergy - 0.5);
                 pairs++;
             }
         }
         return (pairs > 0) ? synergySumDiff / pairs : 0.0;
     };
-    double t1AvgSynDiff = calculateAvgSynergyDiff(team1Brawlers);
-    double t2AvgSynDiff = calculateAvgSynergyDiff(team2Brawlers);
+    double t1AvgSynDiff = calculateAvgSynergyDiff(team1Brawlers, team1Count);
+    double t2AvgSynDiff = calculateAvgSynergyDiff(team2Brawlers, team2Count);
     double synergyDiff = t1AvgSynDiff - t2AvgSynDiff;
 
 
@@ -175,16 +248,18 @@ predictWinProbabilityModel(const QVector<QString>& team1Brawlers,
     double max_t1_vs_t2_score_diff = -1.0; // Max (T1[i] vs T2[j] score - 0.5)
     double max_t2_vs_t1_score_diff = -1.0; // Max (T2[j] vs T1[i] score - 0.5)
     int interactions = 0;
-    for (const auto& b1 : team1Brawlers) {
-        for (const auto& b2 : team2Brawlers) {
+    for (int i = 0; i < team1Count; ++i) {
+        const BrawlerId b1 = team1Brawlers[i];
+        for (int j = 0; j < team2Count; ++j) {
+            const BrawlerId b2 = team2Brawlers[j];
              // T1 vs T2 perspective
-            double t1_vs_t2_score = statsCalculator.getCounterScore(b1, b2, mapName, modeName);
+            double t1_vs_t2_score = tables->counterScore(b1, b2);
             double current_t1_vs_t2_diff = t1_vs_t2_score - 0.5;
             t1_vs_t2_sum_diff += current_t1_vs_t2_diff;
             max_t1_vs_t2_score_diff = std::max(max_t1_vs_t2_score_diff, current_t1_vs_t2_diff);
 
             // T2 vs T1 perspective (for peak calculation)
-            double t2_vs_t1_score = statsCalculator.getCounterScore(b2, b1, mapName, modeName);
+            double t2_vs_t1_score = tables->counterScore(b2, b1);
             double current_t2_vs_t1_diff = t2_vs_t1_score - 0.5;
              max_t2_vs_t1_score_diff = std::max(max_t2_vs_t1_score_diff, current_t2_vs_t1_diff);
 
@@ -193,6 +268,7 @@ predictWinProbabilityModel(const QVector<QString>& team1Brawlers,
     }
     double counterAdvAvg = (interactions > 0) ? t1_vs_t2_sum_diff / interactions : 0.0;
     // Peak counter advantage: How much better is T1's best matchup vs T2's best matchup?
+    // (Both maxima stay at -1 without interactions, so this is 0 then.)
     double peakCounterAdv = max_t1_vs_t2_score_diff - max_t2_vs_t1_score_diff;
 
 
@@ -214,4 +290,43 @@ predictWinProbabilityModel(const QVector<QString>& team1Brawlers,
 
     // Clamp result between 0 and 1
     return std::max(0.0, std::min(1.0, predictedRate));
-}
\ No newline at end of file
+}
+
+double
+predictWinProbabilityModel(const QVector<BrawlerId>& team1Brawlers,
+                           const QVector<BrawlerId>& team2Brawlers,
+                           const MapModeTables* tables,
+                           const HeuristicWeights& evalWeights)
+{
+    if (team1Brawlers.size() != 3 || team2Brawlers.size() != 3) {
+        qWarning() << "predictWinProbabilityModel called with incomplete teams.";
+        return 0.5; // Default for invalid input
+    }
+    return predictFromTeams(team1Brawlers.constData(), 3, team2Brawlers.constData(), 3, tables, evalWeights);
+}
+
+double
+predictWinProbabilityModel(const DraftState& finalState,
+                           const MapModeTables* tables,
+                           const HeuristicWeights& evalWeights)
+{
+    if (!finalState.isComplete()) {
+        qWarning() << "predictWinProbabilityModel called with incomplete teams.";
+        return 0.5;
+    }
+    return evaluateDraftState(finalState, tables, evalWeights);
+}
+
+double
+evaluateDraftState(const DraftState& state,
+                   const MapModeTables* tables,
+                   const HeuristicWeights& evalWeights)
+{
+    // Picks copied straight out of the state, no containers
+    BrawlerId team1[DraftState::TEAM_SIZE], team2[DraftState::TEAM_SIZE];
+    const int team1Count = state.pickCount(DraftState::Turn::Team1);
+    const int team2Count = state.pickCount(DraftState::Turn::Team2);
+    for (int i = 0; i < team1Count; ++i) team1[i] = state.pick(DraftState::Turn::Team1, i);
+    for (int i = 0; i < team2Count; ++i) team2[i] = state.pick(DraftState::Turn::Team2, i);
+    return predictFromTeams(team1, team1Count, team2, team2Count, tables, evalWeights);
+}
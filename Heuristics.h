@@ -3,34 +3,71 @@
 
 #include "DataStructures.h"
 #include "DraftState.h"
-#include "StatsCalculator.h"
+#include "StatsView.h"
 #include "AppConfig.h" // For weights
 #include <QPair>
 #include <QHash>
 #include <QString>
 #include <QVector>
 
-// Suggests a pick based on weighted heuristics
+// ID-based core of the pick heuristic, used directly by MCTS rollouts with
+// tables resolved once per search (nullptr = no stats for the map/mode).
+// Returns INVALID_BRAWLER_ID if there are no legal moves. Per-brawler scores
+// are only collected when scoresOut is given; otherwise nothing is allocated.
+BrawlerId
+bestPickHeuristic(const DraftState& draftState,
+                  const MapModeTables* tables,
+                  const HeuristicWeights& weights,
+                  QHash<BrawlerId, HeuristicScoreComponents>* scoresOut = nullptr);
+
+// Same, resolving the draft's map/mode tables from statsView
+BrawlerId
+bestPickHeuristic(const DraftState& draftState,
+                  const StatsView& statsView,
+                  const HeuristicWeights& weights,
+                  QHash<BrawlerId, HeuristicScoreComponents>* scoresOut = nullptr);
+
+// Total heuristic score of every available brawler into scoresOut[id]
+// (MAX_BRAWLERS entries, others untouched); no allocation. MCTS priors.
+void
+scorePicksHeuristic(const DraftState& draftState,
+                    const MapModeTables* tables,
+                    const HeuristicWeights& weights,
+                    double* scoresOut);
+
+// Suggests a pick based on weighted heuristics (names, for the UI)
 QPair<QString, QHash<QString, HeuristicScoreComponents>>
 suggestPickHeuristic(const DraftState& draftState,
-                     const StatsCalculator& statsCalculator,
+                     const StatsView& statsView,
                      const HeuristicWeights& weights);
 
 // Suggests bans based on high win rate
 QVector<QString>
 suggestBanHeuristic(const DraftState& draftState,
-                    const StatsCalculator& statsCalculator,
+                    const StatsView& statsView,
                     int numSuggestions = 3);
 
 // Predicts win probability for Team 1 based on a heuristic model
 // Note: The weights used here might differ from the pick suggestion weights
 // Using the same HeuristicWeights struct for simplicity, but could be separate.
 double
-predictWinProbabilityModel(const QVector<QString>& team1Brawlers,
-                           const QVector<QString>& team2Brawlers,
-                           const QString& mapName,
-                           const QString& modeName,
-                           const StatsCalculator& statsCalculator,
+predictWinProbabilityModel(const QVector<BrawlerId>& team1Brawlers,
+                           const QVector<BrawlerId>& team2Brawlers,
+                           const MapModeTables* tables, // From StatsView::getMapModeTables
                            const HeuristicWeights& evalWeights); // Weights for evaluation
 
+// Same for a complete draft, read in place (the MCTS rollout evaluation)
+double
+predictWinProbabilityModel(const DraftState& finalState,
+                           const MapModeTables* tables,
+                           const HeuristicWeights& evalWeights);
+
+// Win probability for Team 1 from the picks made so far, at any point of the
+// draft: the same model scoring only the pairs that exist yet (equal to
+// predictWinProbabilityModel once complete). MCTS static leaf evaluation.
+double
+evaluateDraftState(const DraftState& state,
+                   const MapModeTables* tables,
+                   const HeuristicWeights& evalWeights);
+
 #endif // HEURISTICS_H
\ No newline at end of file
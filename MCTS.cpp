@@ -11,57 +11,75 @@
 #include "DataStructures.h"
 
 
+// Helper function for atomic double addition
+void atomic_add_double(std::atomic<double>& atomic_var, double value) {
+    double current_value = atomic_var.load();
+    double desired_value;
+    do {
+        desired_value = current_value + value;
+    } while (!atomic_var.compare_exchange_weak(current_value, desired_value));
+    // compare_exchange_weak updates current_value if it fails, so the loop continues
+    // with the new current value until it succeeds.
+}
+
+
 // --- MCTSNode Implementation ---
 
-MCTSNode::MCTSNode(DraftState s, std::shared_ptr<MCTSNode> p, QString m)
-    : state(std::move(s)), parent(p), move(std::move(m))
+MCTSNode::MCTSNode(const DraftState& s)
+    : state(s)
 {
     isTerminal = state.isComplete();
     if (!isTerminal) {
-        untriedMoves = state.getLegalMoves();
-        // Optional shuffling could happen here using an engine if needed at creation
+        legalMoves = state.available();
+        moveCount = static_cast<quint16>(legalMoves.count());
     }
 }
 
-bool MCTSNode::isFullyExpanded() {
-    QMutexLocker locker(&mutex);
-    return untriedMoves.isEmpty();
-}
-
-std::shared_ptr<MCTSNode> MCTSNode::uctSelectChild(double explorationParam, std::mt19937& randomEngine) {
-    // Selection doesn't modify the node structure (children list), only reads visits/wins.
-    // Reads on atomics are safe without external locks.
-    // Mutex might only be needed if children *vector itself* could be modified,
-    // but expansion is guarded separately. Let's assume reads are fine here.
-
-    if (children.isEmpty()) {
+MCTSNode* MCTSNode::uctSelectChild(const MCTSNodePool& pool, double explorationParam, double virtualLoss, std::mt19937& randomEngine) const {
+    // Selection only reads published edges and the atomic visits/wins; the
+    // edge array never moves once set, so nothing here can block
+    const MCTSEdge* edges = children.load(std::memory_order_acquire);
+    const int slotCount = claimedSlots();
+    if (!edges || slotCount == 0) {
         return nullptr;
     }
 
-    std::shared_ptr<MCTSNode> bestChild = nullptr;
+    MCTSNode* bestChild = nullptr;
     double bestScore = -std::numeric_limits<double>::infinity();
     int parentVisits = visits.load(std::memory_order_relaxed); // Relaxed is ok for reads
 
     if (parentVisits == 0) {
-        if (children.isEmpty()) return nullptr;
-        // Use the PASSED engine for tie-breaking
-        std::uniform_int_distribution<qsizetype> dist(0, children.size() - 1);
-        return children.at(dist(randomEngine));
+        // Nothing to rank by yet: start from a random slot (worker's engine) so
+        // new nodes don't all send their first descent through slot 0
+        std::uniform_int_distribution<int> dist(0, slotCount - 1);
+        const int start = dist(randomEngine);
+        for (int k = 0; k < slotCount; ++k) {
+            MCTSNodeRef ref = edges[(start + k) % slotCount].node.load(std::memory_order_acquire);
+            if (ref != INVALID_NODE_REF) return pool.node(ref);
+        }
+        return nullptr; // Only claimed slots so far
     }
 
+    // A shared child can have more visits than this node (it's also reached
+    // through other parents); its win rate is then just better known, which
+    // the exploration term below already accounts for
     double logParentVisits = log(static_cast<double>(parentVisits));
 
-    // Accessing children vector itself should be safe if expansion is properly locked
-    for (const auto& child : children) {
+    for (int i = 0; i < slotCount; ++i) {
+        MCTSNodeRef ref = edges[i].node.load(std::memory_order_acquire);
+        if (ref == INVALID_NODE_REF) continue; // Claimed, not filled yet
+        MCTSNode* child = pool.node(ref);
         double score = 0.0;
-        int childVisits = child->visits.load(std::memory_order_relaxed);
+        // Pending visits of other workers count as that many lost games
+        double childVisits = child->visits.load(std::memory_order_relaxed);
+        if (virtualLoss > 0.0) {
+            childVisits += virtualLoss * child->pendingVisits.load(std::memory_order_relaxed);
+        }
 
         if (childVisits == 0) {
             score = std::numeric_limits<double>::infinity();
         } else {
             double winRate = child->wins.load(std::memory_order_relaxed) / childVisits;
-            // Prevent log of zero or negative - ensure childVisits > 0 was checked
-            if (childVisits <= 0) continue; // Should not happen if visits > 0 check works
             double exploration = explorationParam * sqrt(logParentVisits / childVisits);
             score = winRate + exploration;
         }
@@ -72,48 +90,149 @@ std::shared_ptr<MCTSNode> MCTSNode::uctSelectChild(double explorationParam, std:
         }
     }
 
-    if (!bestChild && !children.isEmpty()) {
-        qWarning() << "UCT selection failed, returning random.";
-        std::uniform_int_distribution<qsizetype> dist(0, children.size() - 1);
-        return children.at(dist(randomEngine)); // Use PASSED engine
+    return bestChild;
+}
+
+MCTSNode* MCTSNode::puctSelectChild(const MCTSNodePool& pool, double explorationParam, double virtualLoss) const {
+    const MCTSEdge* edges = children.load(std::memory_order_acquire);
+    const int slotCount = claimedSlots();
+    if (!edges || slotCount == 0) {
+        return nullptr;
+    }
+
+    MCTSNode* bestChild = nullptr;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    const double sqrtParentVisits = sqrt(static_cast<double>(std::max(1, visits.load(std::memory_order_relaxed))));
+
+    for (int i = 0; i < slotCount; ++i) {
+        MCTSNodeRef ref = edges[i].node.load(std::memory_order_acquire);
+        if (ref == INVALID_NODE_REF) continue; // Claimed, not filled yet
+        MCTSNode* child = pool.node(ref);
+        double childVisits = child->visits.load(std::memory_order_relaxed);
+        if (virtualLoss > 0.0) {
+            childVisits += virtualLoss * child->pendingVisits.load(std::memory_order_relaxed);
+        }
+        // Unvisited moves start from an even win rate; the prior decides which goes first
+        double winRate = childVisits > 0 ? child->wins.load(std::memory_order_relaxed) / childVisits : 0.5;
+        double score = winRate + explorationParam * edges[i].prior * sqrtParentVisits / (1.0 + childVisits);
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestChild = child;
+        }
     }
 
     return bestChild;
 }
 
-// expand doesn't need the engine if we just take the last move
-std::shared_ptr<MCTSNode> MCTSNode::expand(/*std::mt19937& randomEngine*/) {
-    QMutexLocker locker(&mutex); // Lock untriedMoves and children modification
+int MCTSNode::expansionLimit(double widening) const {
+    if (widening <= 0.0 || moveCount == 0) {
+        return moveCount;
+    }
+    int limit = static_cast<int>(ceil(widening * sqrt(static_cast<double>(visits.load(std::memory_order_relaxed)))));
+    return std::clamp(limit, 1, int(moveCount));
+}
 
-    if (untriedMoves.isEmpty()) {
-        return nullptr;
+MCTSEdge* MCTSNode::createChildren(MCTSArena& arena, const MapModeTables* tables, const HeuristicWeights* priorWeights) const {
+    MCTSEdge* edges = arena.allocateEdges(moveCount);
+    if (!priorWeights) {
+        // Highest ID first (the old list handed out its last entry)
+        int slot = moveCount;
+        legalMoves.forEach([&](BrawlerId id) {
+            --slot;
+            edges[slot].move = id;
+            edges[slot].prior = 1.0f / moveCount;
+        });
+        return edges;
     }
 
-    // --- Take last move (no randomness) ---
-    QString moveToTry = untriedMoves.takeLast();
+    // Best heuristic score first (ties by ID). Priors are a softmax of the
+    // scores in units of their spread, so they don't depend on the weights' scale.
+    double scores[DraftState::MAX_BRAWLERS];
+    BrawlerId order[DraftState::MAX_BRAWLERS];
+    scorePicksHeuristic(state, tables, *priorWeights, scores);
+    int count = 0;
+    double mean = 0.0;
+    legalMoves.forEach([&](BrawlerId id) {
+        order[count++] = id;
+        mean += scores[id];
+    });
+    mean /= count;
+    std::sort(order, order + count, [&scores](BrawlerId a, BrawlerId b) {
+        return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+    });
+    double variance = 0.0;
+    for (int i = 0; i < count; ++i) variance += (scores[order[i]] - mean) * (scores[order[i]] - mean);
+    const double spread = sqrt(variance / count);
+
+    double total = 0.0;
+    for (int i = 0; i < count; ++i) {
+        // All equal (e.g. no stats for the map/mode): uniform priors
+        double weight = spread > 1e-9 ? exp((scores[order[i]] - scores[order[0]]) / spread) : 1.0;
+        edges[i].move = order[i];
+        edges[i].prior = static_cast<float>(weight);
+        total += weight;
+    }
+    for (int i = 0; i < count; ++i) edges[i].prior = static_cast<float>(edges[i].prior / total);
+    return edges;
+}
 
-    // --- Optional: Random move selection ---
-    // if (untriedMoves.isEmpty()) return nullptr;
-    // std::uniform_int_distribution<qsizetype> dist(0, untriedMoves.size() - 1);
-    // qsizetype index = dist(randomEngine); // Use engine if selecting randomly
-    // QString moveToTry = untriedMoves.takeAt(index);
+MCTSNodeRef MCTSNode::expand(MCTSTranspositionTable& table, MCTSArena& arena, int limit,
+                             const MapModeTables* tables, const HeuristicWeights* priorWeights) {
+    // Claim with a CAS so 'claimed' never passes the limit: a slot claimed past
+    // it would never get its child once the limit grows
+    limit = std::min<int>(limit, moveCount);
+    if (arena.isFull()) {
+        return INVALID_NODE_REF; // Memory budget reached: no new nodes (or edge arrays)
+    }
+    const bool singleWriter = table.singleWriter();
+    quint32 slot = claimed.load(std::memory_order_relaxed);
+    if (singleWriter) {
+        if (slot >= quint32(limit)) return INVALID_NODE_REF;
+        claimed.store(slot + 1, std::memory_order_relaxed);
+    } else {
+        do {
+            if (slot >= quint32(limit)) {
+                return INVALID_NODE_REF; // Another worker took the last allowed move
+            }
+        } while (!claimed.compare_exchange_weak(slot, slot + 1, std::memory_order_relaxed));
+    }
 
-    try {
-        DraftState nextState = state.applyMove(moveToTry);
-        // Use shared_from_this() which is safe now due to inheritance
-        auto newNode = std::make_shared<MCTSNode>(nextState, shared_from_this(), moveToTry);
-        children.append(newNode); // Append is thread-safe for QVector if only one thread appends *after locking*
-        return newNode;
-    } catch (const std::exception& e) {
-        qCritical() << "MCTS Expansion Error applying move" << moveToTry << ":" << e.what() << "State:" << state.toString();
-        return nullptr;
-    } catch (...) {
-        qCritical() << "MCTS Expansion Error applying move" << moveToTry << ": Unknown exception. State:" << state.toString();
-        return nullptr;
+    MCTSEdge* edges = children.load(std::memory_order_acquire);
+    if (!edges && singleWriter) {
+        edges = createChildren(arena, tables, priorWeights);
+        children.store(edges, std::memory_order_release);
+    } else if (!edges) {
+        // First expansion: whoever gets here first installs the array; a
+        // worker that loses the race hands its copy back to its arena
+        MCTSEdge* fresh = createChildren(arena, tables, priorWeights);
+        if (children.compare_exchange_strong(edges, fresh, std::memory_order_acq_rel)) {
+            edges = fresh;
+        } else {
+            arena.releaseEdges(fresh, moveCount);
+        }
+    }
+
+    // The edges only hold legal moves, so the unchecked in-place push is safe
+    const BrawlerId moveToTry = edges[slot].move;
+    DraftState nextState = state;
+    nextState.push(moveToTry);
+    MCTSNodeRef childRef = table.findOrCreate(nextState, arena);
+    if (childRef == INVALID_NODE_REF) {
+        return INVALID_NODE_REF; // Arena full: the slot stays empty, roll out from here
     }
+
+    edges[slot].node.store(childRef, std::memory_order_release);
+    return childRef;
 }
 
-void MCTSNode::update(double result) {
+void MCTSNode::update(double result, bool singleWriter) {
+    if (singleWriter) {
+        // Nobody else writes these: no read-modify-write needed
+        visits.store(visits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        wins.store(wins.load(std::memory_order_relaxed) + result, std::memory_order_relaxed);
+        return;
+    }
     // Update visits atomically
     visits.fetch_add(1, std::memory_order_relaxed); // Relaxed is fine for counters
     // Update wins using the compare-and-swap helper
@@ -121,12 +240,233 @@ void MCTSNode::update(double result) {
 }
 
 
+// --- MCTSArena / MCTSNodePool Implementation ---
+
+MCTSArena::MCTSArena(int index, qint64 byteBudget)
+    : m_index(index), m_byteBudget(std::max<qint64>(0, byteBudget)), m_blocks(new MCTSNode*[MAX_BLOCKS]())
+{
+}
+
+MCTSArena::~MCTSArena() {
+    // Nodes are trivially destructible: just hand the blocks back
+    const int blocks = int((nodeCount() + (1u << BLOCK_BITS) - 1) >> BLOCK_BITS);
+    for (int i = 0; i < blocks; ++i) {
+        ::operator delete(m_blocks[i]);
+    }
+    for (MCTSEdge* block : m_edgeBlocks) {
+        delete[] block;
+    }
+}
+
+MCTSNodeRef MCTSArena::create(const DraftState& state) {
+    const quint32 slot = m_nodeCount.load(std::memory_order_relaxed);
+    const quint32 block = slot >> BLOCK_BITS;
+    if (block >= quint32(MAX_BLOCKS) || slot >= (1u << MCTSNodePool::SLOT_BITS) || isFull()) {
+        return INVALID_NODE_REF;
+    }
+    if ((slot & ((1u << BLOCK_BITS) - 1)) == 0) {
+        m_blocks[block] = static_cast<MCTSNode*>(::operator new(sizeof(MCTSNode) << BLOCK_BITS));
+    }
+    new (node(slot)) MCTSNode(state);
+    m_nodeCount.store(slot + 1, std::memory_order_relaxed);
+    return (MCTSNodeRef(m_index) << MCTSNodePool::SLOT_BITS) | slot;
+}
+
+bool MCTSArena::isFull() const {
+    // Checked before a new block would be needed, so the budget is overshot by
+    // at most one node block plus one edge block
+    return nodeCount() >= (quint32(MAX_BLOCKS) << BLOCK_BITS) ||
+           (m_byteBudget > 0 && bytesReserved() >= m_byteBudget);
+}
+
+void MCTSArena::releaseEdges(MCTSEdge* edges, int count) {
+    if (edges + count == m_edgeCursor) {
+        m_edgeCursor = edges;
+        m_edgesLeft += count;
+    }
+}
+
+MCTSEdge* MCTSArena::allocateEdges(int count) {
+    if (count > m_edgesLeft) {
+        // The tail of the old block is left unused (less than MAX_BRAWLERS edges)
+        m_edgeCursor = new MCTSEdge[EDGE_BLOCK_SIZE];
+        m_edgeBlocks.append(m_edgeCursor);
+        m_edgeBlockCount.store(int(m_edgeBlocks.size()), std::memory_order_relaxed);
+        m_edgesLeft = EDGE_BLOCK_SIZE;
+    }
+    MCTSEdge* edges = m_edgeCursor;
+    m_edgeCursor += count;
+    m_edgesLeft -= count;
+    return edges;
+}
+
+qint64 MCTSArena::bytesReserved() const {
+    const qint64 blocks = (nodeCount() + (1u << BLOCK_BITS) - 1) >> BLOCK_BITS;
+    return blocks * (qint64(sizeof(MCTSNode)) << BLOCK_BITS) +
+           qint64(m_edgeBlockCount.load(std::memory_order_relaxed)) * EDGE_BLOCK_SIZE * qint64(sizeof(MCTSEdge));
+}
+
+MCTSNodePool::MCTSNodePool(int arenaCount, qint64 byteBudget) {
+    arenaCount = std::clamp(arenaCount, 1, MAX_ARENAS);
+    m_arenas.reserve(arenaCount);
+    for (int i = 0; i < arenaCount; ++i) {
+        m_arenas.push_back(std::make_unique<MCTSArena>(i, byteBudget / arenaCount));
+    }
+}
+
+bool MCTSNodePool::anyArenaFull() const {
+    for (const auto& arena : m_arenas) {
+        if (arena->isFull()) return true;
+    }
+    return false;
+}
+
+qint64 MCTSNodePool::nodeCount() const {
+    qint64 total = 0;
+    for (const auto& arena : m_arenas) total += arena->nodeCount();
+    return total;
+}
+
+qint64 MCTSNodePool::bytesReserved() const {
+    qint64 total = 0;
+    for (const auto& arena : m_arenas) total += arena->bytesReserved();
+    return total;
+}
+
+
+// --- MCTSTranspositionTable Implementation ---
+
+MCTSTranspositionTable::MCTSTranspositionTable(const MCTSNodePool& pool)
+    : m_pool(pool), m_concurrent(pool.arenaCount() > 1)
+{
+    for (Shard& shard : m_shards) {
+        shard.table.fill({0, INVALID_NODE_REF}, INITIAL_SLOTS);
+    }
+}
+
+MCTSNodeRef MCTSTranspositionTable::findOrCreate(const DraftState& state, MCTSArena& arena) {
+    const quint64 hash = state.hash();
+    Shard& shard = m_shards[hash >> (64 - SHARD_BITS)];
+    QMutexLocker locker(m_concurrent ? &shard.mutex : nullptr); // No lock with a single writer
+
+    if ((shard.count + 1) * 4 > shard.table.size() * 3) grow(shard); // Keep load <= 3/4
+
+    const qsizetype mask = shard.table.size() - 1;
+    for (qsizetype i = static_cast<qsizetype>(hash) & mask; ; i = (i + 1) & mask) {
+        Slot& slot = shard.table[i];
+        if (slot.node == INVALID_NODE_REF) {
+            MCTSNodeRef ref = arena.create(state);
+            if (ref != INVALID_NODE_REF) {
+                slot = {hash, ref};
+                shard.count++;
+            }
+            return ref;
+        }
+        if (slot.hash == hash) {
+            if (m_pool.node(slot.node)->state == state) {
+                if (m_concurrent) m_hits.fetch_add(1, std::memory_order_relaxed);
+                else m_hits.store(m_hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return slot.node;
+            }
+            // 64-bit collision with a different position: give this one its own
+            // node outside the table rather than merging unrelated statistics
+            qWarning() << "MCTS transposition table hash collision; position not shared.";
+            return arena.create(state);
+        }
+    }
+}
+
+MCTSNodeRef MCTSTranspositionTable::find(const DraftState& state) const {
+    const quint64 hash = state.hash();
+    const Shard& shard = m_shards[hash >> (64 - SHARD_BITS)];
+    QMutexLocker locker(&shard.mutex);
+
+    const qsizetype mask = shard.table.size() - 1;
+    for (qsizetype i = static_cast<qsizetype>(hash) & mask; ; i = (i + 1) & mask) {
+        const Slot& slot = shard.table[i];
+        if (slot.node == INVALID_NODE_REF) return INVALID_NODE_REF;
+        if (slot.hash == hash) {
+            return m_pool.node(slot.node)->state == state ? slot.node : INVALID_NODE_REF;
+        }
+    }
+}
+
+void MCTSTranspositionTable::grow(Shard& shard) {
+    QVector<Slot> old = std::move(shard.table);
+    shard.table = QVector<Slot>(old.size() * 2, {0, INVALID_NODE_REF});
+    const qsizetype mask = shard.table.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.node == INVALID_NODE_REF) continue;
+        qsizetype i = static_cast<qsizetype>(slot.hash) & mask;
+        while (shard.table[i].node != INVALID_NODE_REF) i = (i + 1) & mask;
+        shard.table[i] = slot;
+    }
+}
+
+qsizetype MCTSTranspositionTable::size() const {
+    qsizetype total = 0;
+    for (const Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        total += shard.count;
+    }
+    return total;
+}
+
+
+// Copies the node 'ref' of 'from' and everything below it into 'to' (all
+// nodes in 'arena'), statistics included. 'copied' maps old refs to new ones
+// so shared nodes stay shared. Single-threaded: nobody may be searching either tree.
+static MCTSNodeRef copySubtree(const MCTSSearchTree& from, MCTSNodeRef ref, MCTSSearchTree& to, MCTSArena& arena,
+                               QHash<MCTSNodeRef, MCTSNodeRef>& copied)
+{
+    auto it = copied.constFind(ref);
+    if (it != copied.constEnd()) {
+        return it.value();
+    }
+    const MCTSNode* src = from.pool.node(ref);
+    const MCTSNodeRef copyRef = to.table.findOrCreate(src->state, arena);
+    copied.insert(ref, copyRef);
+    if (copyRef == INVALID_NODE_REF) {
+        return copyRef; // Arena full
+    }
+    MCTSNode* dst = to.pool.node(copyRef);
+    dst->wins.store(src->wins.load());
+    dst->visits.store(src->visits.load());
+
+    const MCTSEdge* srcEdges = src->children.load();
+    const int slotCount = srcEdges ? src->claimedSlots() : 0;
+    if (slotCount == 0) {
+        return copyRef;
+    }
+    // Every move keeps its slot and prior (see expand). The children are
+    // copied up to the first empty slot; that move and any after it are
+    // simply expanded again.
+    MCTSEdge* dstEdges = arena.allocateEdges(dst->moveCount);
+    for (int i = 0; i < dst->moveCount; ++i) {
+        dstEdges[i].move = srcEdges[i].move;
+        dstEdges[i].prior = srcEdges[i].prior;
+    }
+    int filled = 0;
+    for (; filled < slotCount; ++filled) {
+        const MCTSNodeRef childRef = srcEdges[filled].node.load();
+        if (childRef == INVALID_NODE_REF) break;
+        const MCTSNodeRef childCopy = copySubtree(from, childRef, to, arena, copied);
+        if (childCopy == INVALID_NODE_REF) break;
+        dstEdges[filled].node.store(childCopy);
+    }
+    dst->children.store(dstEdges);
+    dst->claimed.store(quint32(filled));
+    return copyRef;
+}
+
+
 // --- MCTSManager Implementation ---
 
-MCTSManager::MCTSManager(const StatsCalculator& statsCalculator, const AppConfig& config, QObject *parent)
+MCTSManager::MCTSManager(const StatsView& statsView, const AppConfig& config, QObject *parent)
     : QObject(parent),
-      m_statsCalculator(statsCalculator),
-      m_config(config)
+      m_statsView(statsView),
+      m_appConfig(config),
+      m_config(config.snapshot())
 {
     // Set max threads for the pool (can be adjusted)
     m_threadPool.setMaxThreadCount(QThread::idealThreadCount());
@@ -148,45 +488,102 @@ bool MCTSManager::isRunning() const {
     return m_controllerFuture.isRunning();
 }
 
+long long MCTSManager::iterationCount() const {
+    return m_totalIterationsDone.load(std::memory_order_relaxed);
+}
+
 void MCTSManager::startMcts(DraftState rootState, HeuristicWeights weights) {
     if (isRunning()) {
         qWarning() << "MCTS is already running.";
         emit mctsError("MCTS already running.");
         return;
     }
-    if (rootState.isComplete() || rootState.getLegalMoves().isEmpty()) {
+    if (rootState.isComplete() || rootState.available().isEmpty()) {
         qInfo() << "MCTS not started: Root state terminal or no legal moves.";
         emit mctsFinalResult({});
         emit mctsFinished();
         return;
     }
 
+    // Workers of the last search may still be finishing their final iteration
+    // (on the tree we may reuse); they must see the stop flag before it's reset
+    m_threadPool.waitForDone();
+
     // Reset state variables
     m_stopRequested = false;
     m_totalIterationsDone = 0;
 
-    // Create the shared root node
-    auto rootNode = std::make_shared<MCTSNode>(rootState);
+    // Pick up config changes (e.g. new time limit from the UI). Nothing else
+    // reads m_config while no search is running, so this is safe here.
+    if (m_config.version != m_appConfig.version()) {
+        m_config = m_appConfig.snapshot();
+        m_lastTrees.clear(); // Their statistics came from the old settings (rank window, ...)
+    }
+
+    const int poolThreads = m_config.mctsThreads > 0 ? m_config.mctsThreads : QThread::idealThreadCount(); // 0 = auto
+    if (poolThreads != m_threadPool.maxThreadCount()) {
+        m_threadPool.setMaxThreadCount(poolThreads);
+    }
+    int numThreads = std::min(m_threadPool.maxThreadCount(), MCTSNodePool::MAX_ARENAS); // One arena per worker
+    const bool rootParallel = m_config.mctsParallelMode == MctsParallelMode::RootParallel;
+    if (rootParallel) {
+        qInfo() << "Starting MCTS with" << numThreads << "worker threads, one private tree each.";
+    } else {
+        qInfo() << "Starting MCTS with" << numThreads << "worker threads on a shared tree, virtual loss" << m_config.mctsVirtualLoss;
+    }
 
-    int numThreads = m_threadPool.maxThreadCount(); // Use configured max threads
-    qInfo() << "Starting MCTS with" << numThreads << "worker threads.";
+    // Continue from the last search where it already explored this position,
+    // otherwise create the search tree(s) and root(s) (in arena 0, before any
+    // worker runs)
+    MCTSTreeList lastTrees = std::move(m_lastTrees);
+    if (weights.winRate != m_lastTreeWeights.winRate || weights.synergy != m_lastTreeWeights.synergy ||
+        weights.counter != m_lastTreeWeights.counter || weights.pickRate != m_lastTreeWeights.pickRate) {
+        lastTrees.clear(); // Win rates were estimated with other weights
+    }
+    const int treeCount = rootParallel ? numThreads : 1;
+    const int arenasPerTree = rootParallel ? 1 : numThreads;
+    const qint64 treeBudget = qint64(m_config.mctsMemoryBudgetMB) * 1024 * 1024 / treeCount; // 0 = unlimited
+    MCTSTreeList trees(treeCount);
+    for (int t = 0; t < treeCount; ++t) {
+        if (t < int(lastTrees.size())) {
+            trees[t] = reuseTree(std::move(lastTrees[t]), rootState, arenasPerTree, treeBudget);
+        }
+        if (!trees[t]) {
+            trees[t] = std::make_shared<MCTSSearchTree>(arenasPerTree, treeBudget);
+            trees[t]->root = trees[t]->table.findOrCreate(rootState, trees[t]->pool.arena(0));
+        }
+    }
+    lastTrees.clear(); // Trees beyond treeCount (fewer threads now)
+    m_lastTrees = trees;
+    m_lastTreeWeights = weights;
+    // Every state in the tree shares the root's map/mode; the handle keeps the
+    // tables mapped until the last worker lets go of it
+    StatsView::TablesHandle tables = m_statsView.getMapModeTables(rootState.mapModeId());
 
     // Store needed parameters accessible by workers (capture list or members)
-    double explorationParam = m_config.mctsExplorationParam();
+    double explorationParam = m_config.mctsExplorationParam;
 
     // Launch Worker Threads via Thread Pool
     for (int i = 0; i < numThreads; ++i) {
+        std::shared_ptr<MCTSSearchTree> tree = trees[rootParallel ? i : 0];
+        const int arenaIndex = rootParallel ? 0 : i;
         // Use pool's start() with a lambda
-        m_threadPool.start([this, rootNode, weights, explorationParam, i]() {
+        m_threadPool.start([this, tree, arenaIndex, tables, weights, explorationParam, i]() {
             // Each worker thread gets its own random engine, seeded uniquely
             std::mt19937 threadRandomEngine(std::random_device{}() + i); // Simple unique seeding
 
+            // Iterations are added to the shared counter in batches, so workers
+            // don't all hit the same cache line every iteration
+            constexpr int ITERATION_BATCH = 64;
+            int pendingIterations = 0;
             try {
                  // Worker loop: continues as long as stop is not requested
                 while (!m_stopRequested.load(std::memory_order_relaxed)) {
-                    runSingleMctsIteration(rootNode, weights, explorationParam, threadRandomEngine);
-                    // Increment shared iteration counter atomically
-                    m_totalIterationsDone.fetch_add(1, std::memory_order_relaxed);
+                    runSingleMctsIteration(*tree, tree->pool.arena(arenaIndex), tables.get(), weights, explorationParam, threadRandomEngine);
+                    if (++pendingIterations == ITERATION_BATCH) {
+                        m_totalIterationsDone.fetch_add(pendingIterations, std::memory_order_relaxed);
+                        pendingIterations = 0;
+                    }
                 }
             } catch (const std::exception& e) {
                  qCritical() << "Exception in MCTS worker thread" << i << ":" << e.what();
@@ -195,17 +592,18 @@ void MCTSManager::startMcts(DraftState rootState, HeuristicWeights weights) {
             } catch (...) {
                 qCritical() << "Unknown exception in MCTS worker thread" << i;
             }
+            m_totalIterationsDone.fetch_add(pendingIterations, std::memory_order_relaxed);
              //qDebug() << "MCTS Worker thread" << i << "finished.";
         });
     }
 
     // Launch the Controller Task in a separate thread
-    // Pass rootNode by value (shared_ptr copy), weights by value.
-    m_controllerFuture = QtConcurrent::run([this, rootNode, weights]() {
-        this->runMctsControllerTask(rootNode, weights);
+    // Pass the trees by value (shared_ptr copies), weights by value.
+    m_controllerFuture = QtConcurrent::run([this, trees, weights]() {
+        this->runMctsControllerTask(trees, weights);
     });
 
-    qInfo() << "MCTS controller and worker threads launched for state:" << rootState.toString();
+    qInfo() << "MCTS controller and worker threads launched for state:" << rootState.toString(m_statsView.brawlerRegistry());
     emit mctsStatusUpdate("MCTS Started...");
 }
 
@@ -219,86 +617,116 @@ void MCTSManager::stopMcts() {
     }
 }
 
+std::shared_ptr<MCTSSearchTree> MCTSManager::reuseTree(std::shared_ptr<MCTSSearchTree> old, const DraftState& rootState, int arenaCount, qint64 byteBudget) const {
+    // Whatever happens, the old tree is released when this returns
+    if (!old || old->root == INVALID_NODE_REF) {
+        return nullptr;
+    }
+    // Picks made since are moves in the tree; a changed ban or an undo gives a
+    // position it doesn't contain
+    const MCTSNodeRef ref = old->table.find(rootState);
+    if (ref == INVALID_NODE_REF) {
+        return nullptr;
+    }
+    if (ref == old->root && old->pool.arenaCount() == arenaCount) {
+        qInfo() << "MCTS continuing the previous search tree (" << old->pool.nodeCount() << "nodes).";
+        return old;
+    }
+
+    // Copy just the part below the new root into a fresh tree; dropping the
+    // old one frees every other branch at once
+    auto tree = std::make_shared<MCTSSearchTree>(arenaCount, byteBudget);
+    QHash<MCTSNodeRef, MCTSNodeRef> copied;
+    tree->root = copySubtree(*old, ref, *tree, tree->pool.arena(0), copied);
+    if (tree->root == INVALID_NODE_REF) {
+        return nullptr;
+    }
+    qInfo() << "MCTS reusing" << tree->pool.nodeCount() << "of" << old->pool.nodeCount() << "nodes from the previous search ("
+            << tree->pool.node(tree->root)->visits.load() << "visits at the new root).";
+    return tree;
+}
+
 // New function: Performs one MCTS iteration (Select, Expand, Simulate, Backprop)
 // This is the core logic executed by each worker thread.
-void MCTSManager::runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, const HeuristicWeights& weights, double explorationParam, std::mt19937& randomEngine)
+void MCTSManager::runSingleMctsIteration(MCTSSearchTree& tree, MCTSArena& arena, const MapModeTables* tables, const HeuristicWeights& weights, double explorationParam, std::mt19937& randomEngine)
 {
+    MCTSNode* rootNode = tree.pool.node(tree.root);
+
+    // Nodes visited this iteration, root first. Shared nodes have several
+    // parents, so backpropagation walks this path instead of parent links.
+    MCTSNode* path[DraftState::TOTAL_PICKS + 2];
+    int depth = 0;
+
+    // Virtual loss is only read by other workers; with one worker it's skipped,
+    // and the tree's counters are updated without read-modify-writes
+    const bool singleWriter = tree.table.singleWriter();
+    const double virtualLoss = singleWriter ? 0.0 : m_config.mctsVirtualLoss;
+    // PUCT: priors from the heuristic when a node is first expanded, and
+    // children admitted as its visits grow
+    const bool puct = m_config.mctsSelection == MctsSelection::PUCT;
+    const double widening = puct ? m_config.mctsWidening : 0.0;
+
     // 1. Selection
-    std::shared_ptr<MCTSNode> node = rootNode;
-    while (!node->isTerminal.load() && node->isFullyExpanded()) {
-        auto selectedChild = node->uctSelectChild(explorationParam, randomEngine); // Pass worker's engine
+    MCTSNode* node = rootNode;
+    path[depth++] = node;
+    while (!node->isTerminal && node->isFullyExpanded(node->expansionLimit(widening))) {
+        MCTSNode* selectedChild = puct ? node->puctSelectChild(tree.pool, explorationParam, virtualLoss)
+                                       : node->uctSelectChild(tree.pool, explorationParam, virtualLoss, randomEngine); // Pass worker's engine
         if (!selectedChild) {
-            // This can happen if selection fails concurrently, maybe retry or log warning
-            qWarning() << "MCTS Selection returned null despite node being fully expanded. Retrying selection from root.";
-             // Simple recovery: Restart selection from root for this iteration
-             // A more complex strategy might be needed for high contention.
-            node = rootNode;
-            // Or just return and skip this iteration for this worker?
-            // return;
-            continue; // Retry selection loop
+            // Every slot is claimed but none is filled yet (other workers are
+            // still creating them): treat this node as the leaf
+            break;
         }
         node = selectedChild;
+        if (virtualLoss > 0.0) node->pendingVisits.fetch_add(1, std::memory_order_relaxed);
+        path[depth++] = node;
     }
 
     // 2. Expansion
     // Check terminal state *after* selection loop completes
-    if (!node->isTerminal.load()) {
-         // expand() handles internal locking
-         std::shared_ptr<MCTSNode> expandedNode = node->expand(/*randomEngine*/); // Engine not needed for takeLast()
-         if (expandedNode) {
-             node = expandedNode; // Rollout from the newly expanded node
+    if (!node->isTerminal) {
+         // Lock-free claim of the next child slot
+         MCTSNodeRef expandedRef = node->expand(tree.table, arena, node->expansionLimit(widening), tables, puct ? &weights : nullptr);
+         if (expandedRef != INVALID_NODE_REF) {
+             node = tree.pool.node(expandedRef); // Rollout from the new (or transposed) child
+             if (virtualLoss > 0.0) node->pendingVisits.fetch_add(1, std::memory_order_relaxed);
+             path[depth++] = node;
          }
-         // If expansion failed (returned nullptr, e.g., concurrent expansion finished first),
+         // If expansion failed (e.g. a concurrent expansion took the last move, or the arena is full),
          // 'node' remains the parent node, rollout happens from there.
     }
 
-    // 3. Simulation
+    // 3. Simulation, or scoring the leaf as it is (Static leaf evaluation)
     // simulateRollout needs the worker's random engine
-    double result = simulateRollout(node->state, weights, randomEngine); // Result is win prob for T1
+    double result = (m_config.mctsLeafEvaluation == MctsLeafEvaluation::Static)
+                        ? evaluateDraftState(node->state, tables, weights)
+                        : simulateRollout(node->state, tables, weights, randomEngine); // Result is win prob for T1
 
     // 4. Backpropagation
-    std::shared_ptr<MCTSNode> tempNode = node;
-    std::shared_ptr<MCTSNode> rootShared = rootNode; // Need shared_ptr for comparison
-
-    while (tempNode != nullptr) {
-        QString parentTurn;
-        std::shared_ptr<MCTSNode> parentPtr = tempNode->parent.lock();
-
-        if (parentPtr) {
-             parentTurn = parentPtr->state.currentTurn();
-        } else if (tempNode == rootShared) {
-             // Special case for root node: assume parent turn matches root's turn
-             // Or determine based on who would make the first move *to* the root (usually player 1)
-             parentTurn = rootShared->state.currentTurn(); // Check this logic - who gets the score at root?
-             // Backprop score should be from the perspective of the player *making the move*
-             // If root state is T1's turn, the score should reflect T1's win chance
-        } else {
-             // Parent weak_ptr expired, stop backpropagation
-             break;
-        }
-
-
-        // 'result' = win prob for T1. resultForNode = score for the player whose turn it was at parentPtr.
-        double resultForNode = (parentTurn == "team1") ? result : (1.0 - result);
-
-        tempNode->update(resultForNode); // atomic updates inside
-
-        // Move up the tree
-        tempNode = parentPtr; // Continue with the locked parent pointer
+    // Each node scores the result for the team that moved into it, i.e. whose
+    // turn it was at its parent on this path. Every parent of a shared node has
+    // the same pick number, so that's the same team whichever path was taken.
+    // The root has no parent; it's scored for the team to move there.
+    for (int i = depth - 1; i >= 0; --i) {
+        DraftState::Turn parentTurn = (i > 0 ? path[i - 1] : path[0])->state.currentTurn();
+        double resultForNode = (parentTurn == DraftState::Turn::Team1) ? result : (1.0 - result);
+        path[i]->update(resultForNode, singleWriter);
+        if (virtualLoss > 0.0 && i > 0) path[i]->pendingVisits.fetch_sub(1, std::memory_order_relaxed); // The root never gets one
     }
 }
 
 
 // Renamed: This now ONLY controls timing and reporting, doesn't run iterations itself.
-void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, HeuristicWeights weights) {
+void MCTSManager::runMctsControllerTask(MCTSTreeList trees, HeuristicWeights weights) {
     try {
         QElapsedTimer timer;
         timer.start();
         long long lastIterationCount = 0;
-        double timeLimitMs = m_config.mctsTimeLimit() * 1000.0;
+        double timeLimitMs = m_config.mctsTimeLimit * 1000.0;
         int reportIntervalMs = 200; // How often to check status/emit reports
-        int intermediateResultIntervalMs = m_config.mctsUpdateIntervalIters() > 0 ? 1000 : 0; // Approx interval for intermediate results (e.g., 1 sec)
+        int intermediateResultIntervalMs = m_config.mctsUpdateIntervalIters > 0 ? 1000 : 0; // Approx interval for intermediate results (e.g., 1 sec)
         qint64 nextIntermediateResultTime = intermediateResultIntervalMs > 0 ? timer.elapsed() + intermediateResultIntervalMs : -1;
+        bool budgetLogged = m_config.mctsMemoryBudgetMB <= 0;
 
         qInfo() << "MCTS Controller Task Started.";
 
@@ -308,7 +736,7 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
 
             // Check time limit
             if (elapsed >= timeLimitMs) {
-                qInfo() << "MCTS time limit (" << m_config.mctsTimeLimit() << "s) reached by controller.";
+                qInfo() << "MCTS time limit (" << m_config.mctsTimeLimit << "s) reached by controller.";
                 emit mctsStatusUpdate("MCTS Time Limit Reached");
                 stopMcts(); // Signal workers to stop
                 break; // Exit controller loop
@@ -321,14 +749,26 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
                  emit mctsStatusUpdate(QString("Running MCTS: %1 iter (%2s / %3s)")
                                        .arg(currentIterations)
                                        .arg(elapsed / 1000.0, 0, 'f', 1)
-                                       .arg(m_config.mctsTimeLimit(), 0, 'f', 1));
+                                       .arg(m_config.mctsTimeLimit, 0, 'f', 1));
                  lastIterationCount = currentIterations;
             //}
 
+            // Once a worker's share of MctsMemoryBudgetMB is used up it stops
+            // adding nodes; the search goes on from the existing leaves
+            if (!budgetLogged) {
+                for (const auto& tree : trees) {
+                    if (!tree->pool.anyArenaFull()) continue;
+                    qInfo() << "MCTS memory budget (" << m_config.mctsMemoryBudgetMB << "MB) reached after" << elapsed / 1000.0
+                            << "s; the search tree stops growing.";
+                    budgetLogged = true;
+                    break;
+                }
+            }
+
 
             // Emit intermediate results periodically (based on time now)
             if (intermediateResultIntervalMs > 0 && elapsed >= nextIntermediateResultTime) {
-                QVector<MCTSResult> intermediate = getMctsResults(rootNode);
+                QVector<MCTSResult> intermediate = getMctsResults(trees);
                 emit mctsIntermediateResult(intermediate);
                 nextIntermediateResultTime = elapsed + intermediateResultIntervalMs; // Schedule next report
             }
@@ -345,14 +785,26 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
              emit mctsStatusUpdate("MCTS Stopped Early");
         }
 
-        qInfo() << "MCTS Controller task finishing. Total iterations:" << m_totalIterationsDone.load();
+        qint64 nodeCount = 0, bytesReserved = 0;
+        long long transpositions = 0;
+        for (const auto& tree : trees) {
+            nodeCount += tree->pool.nodeCount();
+            bytesReserved += tree->pool.bytesReserved();
+            transpositions += tree->table.transpositions();
+        }
+        const long long totalIterations = m_totalIterationsDone.load();
+        const double seconds = std::max<qint64>(1, timer.elapsed()) / 1000.0;
+        qInfo() << "MCTS Controller task finishing. Total iterations:" << totalIterations
+                << "(" << qRound64(totalIterations / seconds) << "/s ) Trees:" << trees.size()
+                << "Nodes:" << nodeCount << "(" << (bytesReserved >> 20) << "MB)"
+                << "Transpositions merged:" << transpositions;
 
         // Wait briefly for worker threads to potentially finish their current iteration after stop signal
         // This is optional and might not be strictly necessary.
         // QThread::msleep(50); // Small delay
 
         // Get and emit final results
-        QVector<MCTSResult> finalResults = getMctsResults(rootNode);
+        QVector<MCTSResult> finalResults = getMctsResults(trees);
         emit mctsFinalResult(finalResults);
 
 
@@ -372,78 +824,95 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
 }
 
 
-// Simulate a game rollout using heuristics (Needs engine reference)
-double MCTSManager::simulateRollout(DraftState currentState, const HeuristicWeights& weights, std::mt19937& randomEngine) const {
-    DraftState rolloutState = currentState; // Copy for simulation
+// FastRollout policy: the best win rate among a few random available
+// brawlers. No synergy/counter lookups and nothing allocated, and the
+// sampling keeps rollouts varied where the greedy heuristic always plays the
+// same line.
+static BrawlerId fastRolloutPick(const DraftState& board, const MapModeTables* tables, std::mt19937& randomEngine) {
+    constexpr int CANDIDATES = 4;
+    const int possibleMoves = board.available().count();
+    std::uniform_int_distribution<int> dist(0, possibleMoves - 1);
+    BrawlerId best = INVALID_BRAWLER_ID;
+    double bestWinRate = -1.0;
+    for (int i = 0; i < CANDIDATES; ++i) {
+        BrawlerId candidate = board.available().nth(dist(randomEngine));
+        double wr = tables ? tables->winRate(candidate) : 0.5;
+        if (wr > bestWinRate) {
+            bestWinRate = wr;
+            best = candidate;
+        }
+    }
+    return best;
+}
 
-    while (!rolloutState.isComplete()) {
-        QVector<QString> possibleMoves = rolloutState.getLegalMoves();
-        if (possibleMoves.isEmpty()) {
-            qWarning() << "Rollout reached non-terminal state with no legal moves:" << rolloutState.toString();
+// Simulate a game rollout using heuristics (Needs engine reference)
+double MCTSManager::simulateRollout(const DraftState& currentState, const MapModeTables* tables, const HeuristicWeights& weights, std::mt19937& randomEngine) const {
+    // One copy, then every move is pushed onto it in place
+    DraftState board = currentState;
+
+    while (!board.isComplete()) {
+        const int possibleMoves = board.available().count();
+        if (possibleMoves == 0) {
+            qWarning() << "Rollout reached non-terminal state with no legal moves:" << board.toString(m_statsView.brawlerRegistry());
             break;
         }
 
-        auto [heuristicMove, scores] = suggestPickHeuristic(rolloutState, m_statsCalculator, weights);
-        QString move;
-
-        if (!heuristicMove.isEmpty() && possibleMoves.contains(heuristicMove)) {
-            move = heuristicMove;
-        } else {
+        // ID-based heuristic: no per-candidate score map is built for rollouts
+        BrawlerId move = (m_config.mctsLeafEvaluation == MctsLeafEvaluation::FastRollout)
+                             ? fastRolloutPick(board, tables, randomEngine)
+                             : bestPickHeuristic(board, tables, weights);
+        if (move == INVALID_BRAWLER_ID || !board.isAvailable(move)) {
             // Use the PASSED worker's engine for fallback
-            std::uniform_int_distribution<qsizetype> dist(0, possibleMoves.size() - 1);
-            move = possibleMoves[dist(randomEngine)];
-        }
-
-        try {
-            rolloutState = rolloutState.applyMove(move);
-        } catch (const std::exception& e) {
-            qCritical() << "MCTS Rollout Error applying move" << move << ":" << e.what() << "State:" << rolloutState.toString();
-            break;
+            std::uniform_int_distribution<int> dist(0, possibleMoves - 1);
+            move = board.available().nth(dist(randomEngine));
         }
+        board.push(move); // Legal by construction, no checks needed
     }
 
     // Evaluate final state
-    double winProbTeam1 = 0.5;
-    if (rolloutState.isComplete()) {
-        try {
-            winProbTeam1 = predictWinProbabilityModel(
-                rolloutState.team1Picks(), rolloutState.team2Picks(),
-                rolloutState.mapName(), rolloutState.modeName(),
-                m_statsCalculator, weights);
-        } catch (const std::exception& e) {
-            qCritical() << "Error during MCTS final evaluation:" << e.what();
-            winProbTeam1 = 0.5;
-        }
-    } else {
+    if (!board.isComplete()) {
         qWarning() << "Rollout did not complete. Evaluating intermediate state as 0.5.";
-        winProbTeam1 = 0.5;
+        return 0.5;
     }
-    return winProbTeam1;
+    return predictWinProbabilityModel(board, tables, weights); // Win probability for T1
 }
 
 
 // Extracts the results (top moves) from the root node's children
-QVector<MCTSResult> MCTSManager::getMctsResults(std::shared_ptr<MCTSNode> rootNode) const {
-    QVector<MCTSResult> results;
-    if (!rootNode || rootNode->children.isEmpty()) {
-        return results;
+QVector<MCTSResult> MCTSManager::getMctsResults(const MCTSTreeList& trees) const {
+    // Per move over all trees; moves are BrawlerIds, so plain arrays do
+    int moveVisits[DraftState::MAX_BRAWLERS] = {};
+    double moveWins[DraftState::MAX_BRAWLERS] = {};
+    BrawlerMask seen;
+
+    for (const auto& tree : trees) {
+        if (tree->root == INVALID_NODE_REF) continue;
+        // Workers may still be expanding the root: only claimed slots are read,
+        // skipping any whose child isn't published yet; the edge array never moves
+        const MCTSNode* rootNode = tree->pool.node(tree->root);
+        const MCTSEdge* edges = rootNode->children.load(std::memory_order_acquire);
+        const int slotCount = edges ? rootNode->claimedSlots() : 0;
+
+        for (int i = 0; i < slotCount; ++i) {
+            const MCTSEdge& edge = edges[i];
+            const MCTSNodeRef ref = edge.node.load(std::memory_order_acquire);
+            if (ref == INVALID_NODE_REF) continue;
+            const MCTSNode* child = tree->pool.node(ref);
+            moveVisits[edge.move] += child->visits.load(std::memory_order_relaxed);
+            moveWins[edge.move] += child->wins.load(std::memory_order_relaxed);
+            seen.set(edge.move);
+        }
     }
 
-    // Reading children vector and atomic stats should be safe concurrently
-    // However, if children could be ADDED during this time (they shouldn't if expansion locks), a lock might be needed.
-    // Let's assume expansion lock prevents concurrent modification of the children vector *structure*.
-
-    results.reserve(rootNode->children.size());
-
-    for (const auto& child : rootNode->children) {
-        int childVisits = child->visits.load(std::memory_order_relaxed);
-        if (childVisits > 0) {
-            double childWins = child->wins.load(std::memory_order_relaxed);
-            // Prevent division by zero just in case
-            double winRate = (childVisits > 0) ? (childWins / childVisits) : 0.0;
-            results.append(MCTSResult(child->move, childVisits, winRate));
+    QVector<MCTSResult> results;
+    results.reserve(seen.count());
+    seen.forEach([&](BrawlerId move) {
+        if (moveVisits[move] > 0) {
+            double winRate = moveWins[move] / moveVisits[move];
+            // IDs become names only here, at the result boundary
+            results.append(MCTSResult(m_statsView.brawlerRegistry().nameOf(move), moveVisits[move], winRate));
         }
-    }
+    });
 
     // Sort results
     std::sort(results.begin(), results.end(), [](const MCTSResult& a, const MCTSResult& b) {
@@ -452,4 +921,4 @@ QVector<MCTSResult> MCTSManager::getMctsResults(std::shared_ptr<MCTSNode> rootNo
     });
 
     return results;
-}
\ No newline at end of file
+}
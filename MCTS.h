@@ -9,47 +9,233 @@
 #include <QThreadPool> // <-- ADD
 #include <atomic>
 #include <memory>
+#include <vector>
 #include <random>
 
 #include "DataStructures.h"
 #include "DraftState.h"
-#include "StatsCalculator.h"
+#include "StatsView.h"
 #include "AppConfig.h"
 #include "Heuristics.h"
 
-class MCTSNode;
+// Lock-free add for the node win totals (CAS loop)
+void atomic_add_double(std::atomic<double>& atomic_var, double value);
 
-class MCTSNode : public std::enable_shared_from_this<MCTSNode> {
+class MCTSNodePool;
+class MCTSArena;
+class MCTSTranspositionTable;
+
+// Node handle: arena index in the top ARENA_BITS, slot within that arena below
+using MCTSNodeRef = quint32;
+constexpr MCTSNodeRef INVALID_NODE_REF = 0xFFFFFFFFu;
+
+struct MCTSEdge {
+    std::atomic<MCTSNodeRef> node{INVALID_NODE_REF}; // Set (release) once the child exists
+    BrawlerId move = INVALID_BRAWLER_ID; // Edge label; converted back to a name only when reporting results
+    float prior = 0.0f; // PUCT prior of the move (uniform without priors)
+};
+
+// One position in the search. Nodes live in MCTSArena blocks and are never
+// destroyed one by one, so everything here is trivially destructible.
+// Transposed positions share a node (see MCTSTranspositionTable), so a node
+// can have several parents and has no parent link; backpropagation follows
+// the path the iteration took.
+//
+// Expansion takes no lock: a worker claims the next child slot by bumping
+// 'claimed' and fills it. The first expansion lays out every move in the edge
+// array, highest ID first, or best heuristic prior first with PUCT; the k-th
+// claim expands the k-th move. Slots can be filled out of order, so readers
+// skip slots whose node isn't set yet.
+//
+// Progressive widening (PUCT): claims are capped by a limit that grows with
+// the node's visits, so only the best-scored moves get children at first.
+//
+// A tree with a single arena (RootParallel, or one thread) has only one worker
+// writing it; the controller just reads. Its nodes are then updated with plain
+// relaxed load/store pairs instead of CAS loops and fetch_add: the same
+// instructions as non-atomic counters, but still safe for the controller's
+// concurrent reads.
+//
+// Virtual loss: a worker bumps pendingVisits on each node it descends into and
+// drops it again in backpropagation. Until then the other workers score the
+// node as if each pending visit had been a loss (weighted by the configured
+// strength), so they spread over other lines instead of all following the
+// current best one.
+class MCTSNode {
 public:
     DraftState state;
-    std::weak_ptr<MCTSNode> parent;
-    QString move;
-    QVector<std::shared_ptr<MCTSNode>> children;
-    std::atomic<double> wins{0.0};
+    BrawlerMask legalMoves;               // Fixed at creation
+    std::atomic<MCTSEdge*> children{nullptr}; // moveCount slots, allocated on first expansion
+    std::atomic<double> wins{0.0}; // From the view of the team that moved into this node
     std::atomic<int> visits{0};
-    QVector<QString> untriedMoves;
-    std::atomic<bool> isTerminal{false};
-    QMutex mutex; // Protects untriedMoves and children during expansion
-
-    MCTSNode(DraftState s, std::shared_ptr<MCTSNode> p = nullptr, QString m = "");
-
-    bool isFullyExpanded();
-    // uctSelectChild needs the engine for random tie-breaking/fallback
-    std::shared_ptr<MCTSNode> uctSelectChild(double explorationParam, std::mt19937& randomEngine);
-    // expand needs the engine if random move selection is used (currently takes last)
-    std::shared_ptr<MCTSNode> expand(/*std::mt19937& randomEngine*/); // Engine not needed if just taking last
-    void update(double result);
+    std::atomic<quint32> claimed{0};      // Child slots handed out (<= moveCount)
+    std::atomic<int> pendingVisits{0};    // Iterations through here not backpropagated yet (virtual loss)
+    quint16 moveCount = 0;
+    bool isTerminal = false;
+
+    explicit MCTSNode(const DraftState& s);
+
+    // How many children the node may have now: all moves, or with widening > 0
+    // ceil(widening * sqrt(visits)) of them (at least one)
+    int expansionLimit(double widening) const;
+    // True once 'limit' slots are claimed (the children may still be in flight)
+    bool isFullyExpanded(int limit) const { return claimed.load(std::memory_order_relaxed) >= quint32(limit); }
+    // Slots that may hold a child; check each edge's node before use
+    int claimedSlots() const { return std::min<int>(claimed.load(std::memory_order_acquire), moveCount); }
+    // nullptr if no child has been published yet. virtualLoss = losses counted
+    // per pending visit (0 ignores them)
+    MCTSNode* uctSelectChild(const MCTSNodePool& pool, double explorationParam, double virtualLoss, std::mt19937& randomEngine) const;
+    // Same with PUCT: win rate + c * prior * sqrt(parent visits) / (1 + visits)
+    MCTSNode* puctSelectChild(const MCTSNodePool& pool, double explorationParam, double virtualLoss) const;
+    // Claims and creates the next child if fewer than 'limit' are claimed; it
+    // may be an existing node reached by another path. New nodes and the edge
+    // array come from 'arena'. priorWeights (with tables) orders the moves by
+    // heuristic score on first expansion; nullptr keeps ID order.
+    // INVALID_NODE_REF if the limit is reached or the arena is full.
+    // Claims without a CAS if the table is single-writer (see above).
+    MCTSNodeRef expand(MCTSTranspositionTable& table, MCTSArena& arena, int limit,
+                       const MapModeTables* tables = nullptr, const HeuristicWeights* priorWeights = nullptr);
+    void update(double result, bool singleWriter);
+
+private:
+    // Edge array with every move (and prior) laid out, ready to publish
+    MCTSEdge* createChildren(MCTSArena& arena, const MapModeTables* tables, const HeuristicWeights* priorWeights) const;
+};
+
+static_assert(std::is_trivially_destructible<MCTSNode>::value, "Arena blocks are released without running node destructors");
+
+// Bump allocator for the nodes (and child edge arrays) one worker creates.
+// Only its owner allocates from it; any thread may read nodes through
+// MCTSNodePool::node once their ref has been published. Blocks never move and
+// nodes are never freed individually: the arena releases its blocks when the
+// search tree is dropped. With a byte budget, the arena refuses new nodes once
+// its blocks reach it, so the tree simply stops growing.
+class MCTSArena {
+public:
+    static constexpr int BLOCK_BITS = 12;                   // 4096 nodes per block
+    static constexpr int MAX_BLOCKS = 4096;                 // So at most 16M nodes per arena
+    static constexpr int EDGE_BLOCK_SIZE = 16384;
+
+    MCTSArena(int index, qint64 byteBudget); // byteBudget 0 = only the MAX_BLOCKS limit
+    ~MCTSArena();
+    MCTSArena(const MCTSArena&) = delete;
+    MCTSArena& operator=(const MCTSArena&) = delete;
+
+    // INVALID_NODE_REF once the arena is full
+    MCTSNodeRef create(const DraftState& state);
+    bool isFull() const; // Byte budget or MAX_BLOCKS reached
+    MCTSEdge* allocateEdges(int count); // count <= MAX_BRAWLERS
+    void releaseEdges(MCTSEdge* edges, int count); // Undoes the latest allocateEdges if nothing came after it
+
+    MCTSNode* node(quint32 slot) const { return m_blocks[slot >> BLOCK_BITS] + (slot & ((1u << BLOCK_BITS) - 1)); }
+    quint32 nodeCount() const { return m_nodeCount.load(std::memory_order_relaxed); }
+    qint64 bytesReserved() const;
+
+private:
+    int m_index;
+    qint64 m_byteBudget;
+    std::unique_ptr<MCTSNode*[]> m_blocks; // MAX_BLOCKS entries, filled as needed
+    std::atomic<quint32> m_nodeCount{0};
+    QVector<MCTSEdge*> m_edgeBlocks;
+    std::atomic<int> m_edgeBlockCount{0}; // m_edgeBlocks.size(), for other threads' stats
+    MCTSEdge* m_edgeCursor = nullptr;
+    int m_edgesLeft = 0;
+};
+
+// One arena per worker thread, addressed by MCTSNodeRef
+class MCTSNodePool {
+public:
+    static constexpr int ARENA_BITS = 8;
+    static constexpr int MAX_ARENAS = 1 << ARENA_BITS;
+    static constexpr int SLOT_BITS = 32 - ARENA_BITS;
+
+    // byteBudget (0 = none) is split evenly between the arenas
+    MCTSNodePool(int arenaCount, qint64 byteBudget);
+
+    int arenaCount() const { return int(m_arenas.size()); }
+    MCTSArena& arena(int index) { return *m_arenas[index]; }
+    MCTSNode* node(MCTSNodeRef ref) const {
+        return m_arenas[ref >> SLOT_BITS]->node(ref & ((1u << SLOT_BITS) - 1));
+    }
+
+    qint64 nodeCount() const;
+    qint64 bytesReserved() const;
+    bool anyArenaFull() const;
+
+private:
+    std::vector<std::unique_ptr<MCTSArena>> m_arenas;
+};
+
+// All nodes of one search keyed by DraftState::hash(). Picks 2-3 and 4-5 are
+// made by the same team, so e.g. "A then B" and "B then A" reach one shared
+// node and their statistics add up. Split into shards with their own lock and
+// open addressing table of (hash, ref) slots, as in BattleDedup, so concurrent
+// expansions rarely wait on each other and entries cost no allocation. The
+// table of a single-arena pool has one writer, and its lookups take no lock.
+class MCTSTranspositionTable {
+public:
+    explicit MCTSTranspositionTable(const MCTSNodePool& pool);
+    MCTSTranspositionTable(const MCTSTranspositionTable&) = delete;
+    MCTSTranspositionTable& operator=(const MCTSTranspositionTable&) = delete;
+
+    // The node for 'state', created in 'arena' if the position isn't known yet.
+    // INVALID_NODE_REF if it had to be created and the arena is full.
+    MCTSNodeRef findOrCreate(const DraftState& state, MCTSArena& arena);
+    // The node for 'state' or INVALID_NODE_REF; doesn't count as a transposition.
+    // Like size(), only safe on a single-writer table while no worker runs.
+    MCTSNodeRef find(const DraftState& state) const;
+    bool singleWriter() const { return !m_concurrent; } // One arena, so one worker expanding
+
+    qsizetype size() const;
+    long long transpositions() const { return m_hits.load(std::memory_order_relaxed); } // Lookups that found a node
+
+private:
+    static constexpr int SHARD_BITS = 6;
+    static constexpr int SHARD_COUNT = 1 << SHARD_BITS;
+    static constexpr qsizetype INITIAL_SLOTS = 1024; // Per shard, power of two
+
+    struct Slot {
+        quint64 hash;
+        MCTSNodeRef node; // INVALID_NODE_REF = empty
+    };
+    struct Shard {
+        mutable QMutex mutex;
+        QVector<Slot> table;
+        qsizetype count = 0;
+    };
+    static void grow(Shard& shard);
+
+    const MCTSNodePool& m_pool;
+    const bool m_concurrent; // More than one arena: findOrCreate locks its shard
+    Shard m_shards[SHARD_COUNT];
+    std::atomic<long long> m_hits{0};
+};
+
+// Everything one search allocates. Workers and the controller share it; when
+// the last of them lets go, the arenas drop their blocks and the whole graph
+// is gone without visiting a single node.
+struct MCTSSearchTree {
+    MCTSSearchTree(int arenaCount, qint64 byteBudget) : pool(arenaCount, byteBudget), table(pool) {}
+
+    MCTSNodePool pool;
+    MCTSTranspositionTable table;
+    MCTSNodeRef root = INVALID_NODE_REF;
 };
 
+// The trees of one search: a single one all workers grow (SharedTree), or one
+// per worker, each with a single arena (RootParallel)
+using MCTSTreeList = std::vector<std::shared_ptr<MCTSSearchTree>>;
+
 
 class MCTSManager : public QObject {
     Q_OBJECT
 
 public:
-    MCTSManager(const StatsCalculator& statsCalculator, const AppConfig& config, QObject *parent = nullptr);
+    MCTSManager(const StatsView& statsView, const AppConfig& config, QObject *parent = nullptr);
     ~MCTSManager();
 
     bool isRunning() const; // Checks if the controller task is running
+    long long iterationCount() const; // Iterations of the running (or last) search, all workers
 
 public slots:
     void startMcts(DraftState rootState, HeuristicWeights weights);
@@ -64,22 +250,35 @@ signals:
 
 private:
     // Renamed: This is now the controller task managing time/reporting
-    void runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, HeuristicWeights weights);
+    void runMctsControllerTask(MCTSTreeList trees, HeuristicWeights weights);
     // New: Represents the work done by ONE iteration in a worker thread
-    void runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, const HeuristicWeights& weights, double explorationParam, std::mt19937& randomEngine);
+    void runSingleMctsIteration(MCTSSearchTree& tree, MCTSArena& arena, const MapModeTables* tables, const HeuristicWeights& weights, double explorationParam, std::mt19937& randomEngine);
 
-    QVector<MCTSResult> getMctsResults(std::shared_ptr<MCTSNode> rootNode) const;
+    // A previous search's tree re-rooted at 'rootState' if that position is
+    // in it (e.g. after one more pick); nullptr if there's nothing to reuse
+    std::shared_ptr<MCTSSearchTree> reuseTree(std::shared_ptr<MCTSSearchTree> old, const DraftState& rootState, int arenaCount, qint64 byteBudget) const;
+
+    // Root children of every tree, visits and wins added up per move
+    QVector<MCTSResult> getMctsResults(const MCTSTreeList& trees) const;
     // simulateRollout now needs the engine reference again
-    double simulateRollout(DraftState currentState, const HeuristicWeights& weights, std::mt19937& randomEngine) const;
+    // tables: the root's map/mode, resolved once per search (nullptr = no stats)
+    // Picks come from the heuristic or the fast policy (m_config.mctsLeafEvaluation)
+    double simulateRollout(const DraftState& currentState, const MapModeTables* tables, const HeuristicWeights& weights, std::mt19937& randomEngine) const;
 
-    const StatsCalculator& m_statsCalculator;
-    const AppConfig& m_config;
+    const StatsView& m_statsView;
+    const AppConfig& m_appConfig; // Only read in startMcts to refresh m_config
+    ConfigSnapshot m_config;      // What the controller/workers actually use
 
     QThreadPool m_threadPool; // Manages worker threads
     QFuture<void> m_controllerFuture; // Tracks the controller task
     std::atomic<bool> m_stopRequested{false};
     std::atomic<long long> m_totalIterationsDone{0}; // Counter across threads
 
+    // Trees of the last search, kept so the next one can continue from them.
+    // Only touched in startMcts, once the previous workers are done.
+    MCTSTreeList m_lastTrees;
+    HeuristicWeights m_lastTreeWeights; // Their rollouts used these
+
     // Remove m_randomEngine; workers use their own
 };
 
@@ -22,15 +22,13 @@
 
 
 // Constructor (no changes needed here unless dependencies changed)
-MainWindow::MainWindow(const StatsCalculator& statsCalculator,
-                       const QSet<QString>& allBrawlers,
+MainWindow::MainWindow(StatsView& statsView,
                        const QHash<QString, QSet<QString>>& mapModeData,
                        AppConfig& config,
                        MCTSManager* mctsManager,
                        QWidget *parent)
     : QMainWindow(parent),
-      m_statsCalculator(statsCalculator),
-      m_allBrawlersMasterList(allBrawlers),
+      m_statsView(statsView),
       m_mapModeData(mapModeData),
       m_config(config),
       m_mctsManager(mctsManager)
@@ -60,6 +58,10 @@ void MainWindow::setupUi() {
     m_mctsTimeLineEdit = new QLineEdit(QString::number(m_config.mctsTimeLimit()));
     m_mctsTimeLineEdit->setValidator(new QDoubleValidator(0.1, 600.0, 1, this));
     m_mctsTimeLineEdit->setFixedWidth(50);
+    m_rankFloorLineEdit = new QLineEdit(QString::number(m_config.rankFloor()));
+    m_rankFloorLineEdit->setValidator(new QIntValidator(0, 255, this));
+    m_rankFloorLineEdit->setFixedWidth(40);
+    m_rankFloorLineEdit->setToolTip("Only count players of this rank and up in win/pick rates (0 = all ranks)");
     m_resetButton = new QPushButton("Reset Draft");
 
     controlLayout->addWidget(new QLabel("Mode:"));
@@ -67,6 +69,8 @@ void MainWindow::setupUi() {
     controlLayout->addWidget(new QLabel("Map:"));
     controlLayout->addWidget(m_mapComboBox);
     controlLayout->addStretch(1);
+    controlLayout->addWidget(new QLabel("Min Rank:"));
+    controlLayout->addWidget(m_rankFloorLineEdit);
     controlLayout->addWidget(new QLabel("MCTS Time (s):"));
     controlLayout->addWidget(m_mctsTimeLineEdit);
     controlLayout->addWidget(m_resetButton);
@@ -189,6 +193,7 @@ void MainWindow::setupConnections() {
     connect(m_mapComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onMapChanged(int)));
     connect(m_resetButton, &QPushButton::clicked, this, &MainWindow::onResetDraftClicked);
     connect(m_mctsTimeLineEdit, &QLineEdit::editingFinished, this, &MainWindow::validateMctsTimeInput);
+    connect(m_rankFloorLineEdit, &QLineEdit::editingFinished, this, &MainWindow::validateRankFloorInput);
 
     // Display Frame (Drafting Area)
     connect(m_searchLineEdit, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
@@ -237,6 +242,7 @@ void MainWindow::loadInitialData() {
 void MainWindow::onModeChanged(int index) {
     if (index < 0) return;
     QString selectedMode = m_modeComboBox->itemText(index);
+    m_statsView.prefetchMode(selectedMode); // Page in this mode's maps while the user picks one
 
     m_mapComboBox->clear();
     if (m_mapModeData.contains(selectedMode)) {
@@ -284,6 +290,29 @@ void MainWindow::validateMctsTimeInput() {
     }
 }
 
+void MainWindow::validateRankFloorInput() {
+    bool ok;
+    int floor = m_rankFloorLineEdit->text().toInt(&ok);
+    if (!ok || floor < 0) {
+        QMessageBox::warning(this, "Invalid Input", "Min Rank must be 0 (all ranks) or a positive rank.");
+        m_rankFloorLineEdit->setText(QString::number(m_config.rankFloor()));
+        return;
+    }
+    const int previousFloor = m_config.rankFloor();
+    if (floor == previousFloor) return;
+    m_config.setRankFloor(floor);
+    if (!m_statsView.setRankWindow(m_config.snapshot())) { // Next suggestion/search uses the new rates
+        m_config.setRankFloor(previousFloor);
+        m_rankFloorLineEdit->setText(QString::number(previousFloor));
+        QMessageBox::warning(this, "Rank Filter Unavailable",
+                             "The stats cache has no per-rank counts (converted from an old cache), so it can't be filtered by rank.\n"
+                             "Delete the cache to rebuild it from the data file.");
+        return;
+    }
+    setStatus(floor > 0 ? QString("Stats now count rank %1+ players only.").arg(floor)
+                        : QString("Stats now count players of every rank."));
+}
+
 
 void MainWindow::initializeDraft() {
     if (m_mctsManager->isRunning()) {
@@ -301,10 +330,18 @@ void MainWindow::initializeDraft() {
         return;
     }
 
+    const int mapModeId = m_statsView.mapModeId(map, mode);
+    if (mapModeId < 0) {
+        setStatus(QString("No stats for %1 - %2.").arg(mode, map), true);
+        m_currentDraftState.reset();
+        updateUiFromState();
+        return;
+    }
+
     try {
-        m_currentDraftState.emplace(map, mode, m_allBrawlersMasterList);
+        m_currentDraftState.emplace(mapModeId, m_statsView.brawlerRegistry().size());
         setStatus(QString("New draft started for %1 - %2.").arg(mode, map));
-        qInfo() << "Initialized new draft:" << m_currentDraftState->toString();
+        qInfo() << "Initialized new draft:" << m_currentDraftState->toString(m_statsView.brawlerRegistry());
     } catch (const std::exception& e) {
         qCritical() << "Error initializing DraftState:" << e.what();
         QMessageBox::critical(this, "Error", QString("Failed to initialize draft state:\n%1").arg(e.what()));
@@ -323,45 +360,34 @@ void MainWindow::initializeDraft() {
 // --- Draft Action Slots ---
 // onPickTeam1Clicked, onPickTeam2Clicked, onBanClicked, onUnbanClicked (No changes needed)
 void MainWindow::onPickTeam1Clicked() {
-    if (!m_currentDraftState || m_mctsManager->isRunning()) return;
-    QString brawler = getSelectedListWidgetItemText(m_availableListWidget);
-    if (brawler.isEmpty()) { setStatus("Select a brawler from 'Available'.", true); return; }
-
-    try {
-        if (m_currentDraftState->currentTurn() != "team1") throw std::logic_error("Not Team 1's turn.");
-        m_currentDraftState = m_currentDraftState->applyMove(brawler); // Update state
-        setStatus(QString("Picked %1 for T1.").arg(brawler), false, true);
-        qInfo() << "Action: Picked" << brawler << "for T1. New state:" << m_currentDraftState->toString();
-        updateUiFromState();
-    } catch (const std::exception& e) {
-        setStatus(QString("Invalid Action: %1").arg(e.what()), true);
-        qWarning() << "Invalid action (Pick T1):" << e.what();
-        QMessageBox::warning(this, "Invalid Action", e.what());
-         if (m_currentDraftState) {
-            if (!m_currentDraftState->availableBrawlers().contains(brawler)) {
-                 qWarning() << "UI inconsistency detected. Refreshing available list.";
-                 updateAvailableListDisplay();
-            }
-         }
-    }
+    pickForTeam(DraftState::Turn::Team1);
 }
 void MainWindow::onPickTeam2Clicked() {
-     if (!m_currentDraftState || m_mctsManager->isRunning()) return;
+    pickForTeam(DraftState::Turn::Team2);
+}
+
+// Shared by both pick buttons; 'team' must be the side to move
+void MainWindow::pickForTeam(DraftState::Turn team) {
+    if (!m_currentDraftState || m_mctsManager->isRunning()) return;
     QString brawler = getSelectedListWidgetItemText(m_availableListWidget);
     if (brawler.isEmpty()) { setStatus("Select a brawler from 'Available'.", true); return; }
 
+    const QString teamLabel = team == DraftState::Turn::Team1 ? "T1" : "T2";
+    const BrawlerId id = m_statsView.brawlerRegistry().idOf(brawler);
     try {
-        if (m_currentDraftState->currentTurn() != "team2") throw std::logic_error("Not Team 2's turn.");
-        m_currentDraftState = m_currentDraftState->applyMove(brawler);
-        setStatus(QString("Picked %1 for T2.").arg(brawler), false, true);
-         qInfo() << "Action: Picked" << brawler << "for T2. New state:" << m_currentDraftState->toString();
+        if (m_currentDraftState->currentTurn() != team) {
+            throw std::logic_error(team == DraftState::Turn::Team1 ? "Not Team 1's turn." : "Not Team 2's turn.");
+        }
+        m_currentDraftState = m_currentDraftState->applyMove(id); // Update state
+        setStatus(QString("Picked %1 for %2.").arg(brawler, teamLabel), false, true);
+        qInfo() << "Action: Picked" << brawler << "for" << teamLabel << ". New state:" << m_currentDraftState->toString(m_statsView.brawlerRegistry());
         updateUiFromState();
     } catch (const std::exception& e) {
         setStatus(QString("Invalid Action: %1").arg(e.what()), true);
-        qWarning() << "Invalid action (Pick T2):" << e.what();
+        qWarning() << "Invalid action (Pick" << teamLabel << "):" << e.what();
         QMessageBox::warning(this, "Invalid Action", e.what());
          if (m_currentDraftState) {
-            if (!m_currentDraftState->availableBrawlers().contains(brawler)) {
+            if (!m_currentDraftState->isAvailable(id)) {
                  qWarning() << "UI inconsistency detected. Refreshing available list.";
                  updateAvailableListDisplay();
             }
@@ -373,18 +399,19 @@ void MainWindow::onBanClicked() {
     QString brawler = getSelectedListWidgetItemText(m_availableListWidget);
     if (brawler.isEmpty()) { setStatus("Select a brawler from 'Available'.", true); return; }
 
+    const BrawlerId id = m_statsView.brawlerRegistry().idOf(brawler);
     try {
-         if (m_currentDraftState->bans().size() >= 6) throw std::logic_error("Max bans (6) reached.");
-        m_currentDraftState = m_currentDraftState->applyBan(brawler);
+         if (m_currentDraftState->banCount() >= DraftState::MAX_BANS) throw std::logic_error("Max bans (6) reached.");
+        m_currentDraftState = m_currentDraftState->applyBan(id);
         setStatus(QString("Banned %1.").arg(brawler), false, true);
-         qInfo() << "Action: Banned" << brawler << ". New state:" << m_currentDraftState->toString();
+         qInfo() << "Action: Banned" << brawler << ". New state:" << m_currentDraftState->toString(m_statsView.brawlerRegistry());
         updateUiFromState();
     } catch (const std::exception& e) {
         setStatus(QString("Invalid Action: %1").arg(e.what()), true);
         qWarning() << "Invalid action (Ban):" << e.what();
         QMessageBox::warning(this, "Invalid Action", e.what());
          if (m_currentDraftState) {
-            if (!m_currentDraftState->availableBrawlers().contains(brawler)) {
+            if (!m_currentDraftState->isAvailable(id)) {
                  qWarning() << "UI inconsistency detected. Refreshing available list.";
                  updateAvailableListDisplay();
             }
@@ -396,32 +423,25 @@ void MainWindow::onUnbanClicked() {
     QString brawler = getSelectedListWidgetItemText(m_bansListWidget);
     if (brawler.isEmpty()) { setStatus("Select a brawler from 'Bans'.", true); return; }
 
-    if (!m_currentDraftState->bans().contains(brawler)) {
+    const BrawlerId id = m_statsView.brawlerRegistry().idOf(brawler);
+    if (!m_currentDraftState->bans().test(id)) {
         setStatus(QString("Error: %1 not found in bans.").arg(brawler), true);
         return;
     }
 
-    QSet<QString> nextBans = m_currentDraftState->bans();
-    nextBans.remove(brawler);
-
     try {
-         m_currentDraftState.emplace(m_currentDraftState->mapName(), m_currentDraftState->modeName(),
-                                    m_allBrawlersMasterList, nextBans,
-                                    m_currentDraftState->team1Picks(), m_currentDraftState->team2Picks(),
-                                    m_currentDraftState->currentTurn(), m_currentDraftState->currentPickNumber());
+        m_currentDraftState = m_currentDraftState->removeBan(id);
         setStatus(QString("Unbanned %1.").arg(brawler), false, true);
-        qInfo() << "Action: Unbanned" << brawler << ". New state:" << m_currentDraftState->toString();
+        qInfo() << "Action: Unbanned" << brawler << ". New state:" << m_currentDraftState->toString(m_statsView.brawlerRegistry());
         updateUiFromState();
     } catch (const std::exception& e) {
          setStatus(QString("Error during unban: %1").arg(e.what()), true);
-         qCritical() << "Error recreating state after unban: " << e.what();
+         qCritical() << "Error during unban: " << e.what();
          QMessageBox::critical(this, "Error", QString("Failed to unban:\n%1").arg(e.what()));
          updateUiFromState();
     }
 }
 
-// --- MODIFIED: onUndoPickClicked ---
-// --- MODIFIED: onUndoPickClicked ---
 void MainWindow::onUndoPickClicked() {
     // **CRITICAL CHECK:** Ensure MCTS is not running before attempting undo
     if (m_mctsManager->isRunning()) {
@@ -436,9 +456,7 @@ void MainWindow::onUndoPickClicked() {
        return;
     }
 
-    // Allow undo even if the draft is technically complete (pick number > 6)
-    // if (m_currentDraftState->isComplete()){ setStatus("Cannot undo, draft complete."); return; } // REMOVED
-
+    // Undo is allowed even once the draft is complete (pick number 7)
     int currentPickNum = m_currentDraftState->currentPickNumber();
     if (currentPickNum <= 1) {
         setStatus("Cannot undo first pick.");
@@ -447,107 +465,29 @@ void MainWindow::onUndoPickClicked() {
 
     qInfo() << "Attempting to undo pick number" << (currentPickNum - 1);
 
-    // Store current state details before modification, in case recreation fails
-    QString currentMap = m_currentDraftState->mapName();
-    QString currentMode = m_currentDraftState->modeName();
-    QSet<QString> currentBans = m_currentDraftState->bans();
-
-
-    // --- Logic to determine previous state ---
-    int prevPickNum = currentPickNum - 1;
-    QString prevTurn = "";
-    QString lastPickedBrawler = "";
-    // Make copies to modify for the potential previous state
-    QVector<QString> prevTeam1Picks = m_currentDraftState->team1Picks();
-    QVector<QString> prevTeam2Picks = m_currentDraftState->team2Picks();
-
-    // Determine previous turn and remove last pick based on *current* pick number
-    // (The pick number *before* the one being undone)
-    switch (currentPickNum) {
-        // Who made pick 'prevPickNum' (which is currentPickNum - 1)?
-        case 2: // T1 made pick 1
-            prevTurn = "team1";
-            if (!prevTeam1Picks.isEmpty()) {
-               lastPickedBrawler = prevTeam1Picks.last(); // Get brawler first
-               prevTeam1Picks.removeLast();               // Then remove
-            }
-            break;
-        case 3: // T2 made pick 2
-            prevTurn = "team2";
-            if (!prevTeam2Picks.isEmpty()) {
-               lastPickedBrawler = prevTeam2Picks.last();
-               prevTeam2Picks.removeLast();
-            }
-            break;
-        case 4: // T2 made pick 3
-            prevTurn = "team2";
-            if (!prevTeam2Picks.isEmpty()) {
-                lastPickedBrawler = prevTeam2Picks.last();
-                prevTeam2Picks.removeLast();
-             }
-            break;
-        case 5: // T1 made pick 4
-            prevTurn = "team1";
-            if (!prevTeam1Picks.isEmpty()) {
-                lastPickedBrawler = prevTeam1Picks.last();
-                prevTeam1Picks.removeLast();
-            }
-            break;
-        case 6: // T1 made pick 5
-            prevTurn = "team1";
-            if (!prevTeam1Picks.isEmpty()) {
-                 lastPickedBrawler = prevTeam1Picks.last();
-                 prevTeam1Picks.removeLast();
-             }
-            break;
-        case 7: // T2 made pick 6 (State is AFTER pick 6, so undoing pick 6)
-            prevTurn = "team2"; // The player whose turn it becomes is T2 (to make pick 6 again)
-            if (!prevTeam2Picks.isEmpty()) {
-                lastPickedBrawler = prevTeam2Picks.last();
-                prevTeam2Picks.removeLast();
-            }
-            // Corrected Logic: When pick # is 7 (after pick 6), undoing means going
-            // back to pick #6, and it was T2's turn to make that pick.
-            break;
-        default:
-            qWarning() << "Undo error: Unexpected current pick number" << currentPickNum;
-            setStatus("Undo failed (invalid state).", true);
-            return;
-    }
+    // The team that made the previous pick gets the turn back; its last pick is the one undone
+    const DraftState::Turn prevTurn = DraftState::turnForPick(currentPickNum - 1);
+    const int prevTeamPicks = m_currentDraftState->pickCount(prevTurn);
+    const QString lastPickedBrawler = prevTeamPicks > 0
+        ? m_statsView.brawlerRegistry().nameOf(m_currentDraftState->pick(prevTurn, prevTeamPicks - 1))
+        : QString();
 
-    // Check if a brawler was actually removed (handles empty team lists unexpectedly)
-    if (lastPickedBrawler.isEmpty()) {
-        qWarning() << "Undo error: Could not determine last picked brawler for pick number" << currentPickNum;
-        setStatus("Undo failed (state error).", true);
-        return;
-    }
-
-    // --- Recreate the previous state ---
     try {
-         m_currentDraftState.emplace(currentMap, currentMode, // Use stored map/mode
-                                    m_allBrawlersMasterList, currentBans, // Use stored bans
-                                    prevTeam1Picks, prevTeam2Picks, // Use modified pick lists
-                                    prevTurn, prevPickNum); // Use calculated previous turn/pick#
+        m_currentDraftState = m_currentDraftState->undoLastPick();
 
         // Success: Update status and UI
         setStatus(QString("Undid pick of %1. Back to pick %2 (%3's turn).")
-                    .arg(lastPickedBrawler).arg(prevPickNum).arg(prevTurn), false, true);
-        qInfo() << "Undo successful. Reverted state:" << m_currentDraftState->toString();
+                    .arg(lastPickedBrawler).arg(m_currentDraftState->currentPickNumber())
+                    .arg(DraftState::turnName(prevTurn)), false, true);
+        qInfo() << "Undo successful. Reverted state:" << m_currentDraftState->toString(m_statsView.brawlerRegistry());
         updateUiFromState(); // Update UI *after* successful state change
 
     } catch (const std::exception& e) {
-        // Failed to recreate state - this indicates a bug in DraftState constructor or logic above
-        setStatus(QString("Error recreating state after undo: %1").arg(e.what()), true);
-        qCritical() << "Error during undo state recreation: " << e.what();
-        QMessageBox::critical(this, "Undo Error", QString("Failed to undo - Error recreating state:\n%1").arg(e.what()));
-        // State might be inconsistent, try to force UI update based on potentially corrupt state
+        // The state is left unchanged on failure
+        setStatus(QString("Undo failed: %1").arg(e.what()), true);
+        qCritical() << "Error during undo: " << e.what();
+        QMessageBox::critical(this, "Undo Error", QString("Failed to undo:\n%1").arg(e.what()));
         updateUiFromState();
-    } catch (...) {
-       // Catch any other unexpected errors during state recreation
-       setStatus("Unknown error recreating state after undo.", true);
-       qCritical() << "Unknown error during undo state recreation.";
-       QMessageBox::critical(this, "Undo Error", "Failed to undo - Unknown error recreating state.");
-       updateUiFromState();
     }
 }
 
@@ -555,11 +495,11 @@ void MainWindow::onUndoPickClicked() {
 void MainWindow::onAvailableListDoubleClicked(QListWidgetItem *item) {
     if (!item || !m_currentDraftState || m_mctsManager->isRunning()) return;
     const DraftState& ds = *m_currentDraftState;
-    if (ds.currentTurn() == "team1" && ds.team1Picks().size() < 3) {
+    if (ds.currentTurn() == DraftState::Turn::Team1 && ds.pickCount(DraftState::Turn::Team1) < DraftState::TEAM_SIZE) {
         onPickTeam1Clicked();
-    } else if (ds.currentTurn() == "team2" && ds.team2Picks().size() < 3) {
+    } else if (ds.currentTurn() == DraftState::Turn::Team2 && ds.pickCount(DraftState::Turn::Team2) < DraftState::TEAM_SIZE) {
         onPickTeam2Clicked();
-    } else if (ds.bans().size() < 6 && !ds.isComplete()) {
+    } else if (ds.banCount() < DraftState::MAX_BANS && !ds.isComplete()) {
         onBanClicked();
     } else {
          setStatus(QString("Cannot auto-pick/ban %1 currently.").arg(item->text()));
@@ -598,7 +538,7 @@ void MainWindow::onSuggestHeuristicClicked() {
     QCoreApplication::processEvents(); // Allow UI update
 
     try {
-        auto [bestPick, scoresDict] = suggestPickHeuristic(*m_currentDraftState, m_statsCalculator, weights);
+        auto [bestPick, scoresDict] = suggestPickHeuristic(*m_currentDraftState, m_statsView, weights);
 
         if (!bestPick.isEmpty()) {
             m_suggestionLabel->setText(QString("Heuristic Suggestion: %1").arg(bestPick));
@@ -647,7 +587,7 @@ void MainWindow::onSuggestBanClicked() {
         setStatus("Cannot suggest ban: Draft not active or complete."); return;
      }
      if (m_mctsManager->isRunning()) { setStatus("Stop MCTS first."); return; }
-     if (m_currentDraftState->bans().size() >= 6) { setStatus("Max bans reached."); return; }
+     if (m_currentDraftState->banCount() >= DraftState::MAX_BANS) { setStatus("Max bans reached."); return; }
 
 
     setStatus("Calculating ban suggestions...");
@@ -658,7 +598,7 @@ void MainWindow::onSuggestBanClicked() {
 
     try {
          int numSuggestions = 5;
-        QVector<QString> suggestedBans = suggestBanHeuristic(*m_currentDraftState, m_statsCalculator, numSuggestions);
+        QVector<QString> suggestedBans = suggestBanHeuristic(*m_currentDraftState, m_statsView, numSuggestions);
 
         if (!suggestedBans.isEmpty()) {
             m_suggestionLabel->setText(QString("Ban Suggestions: %1").arg(QStringList::fromVector(suggestedBans).join(", ")));
@@ -757,24 +697,14 @@ void MainWindow::updateUiFromState() {
 
     if (draftActive && !mctsRunning) {
         const DraftState& ds = *m_currentDraftState;
-        updateAvailableListDisplay();
-
-        for (const auto& b : ds.team1Picks()) m_team1ListWidget->addItem(b);
-        for (const auto& b : ds.team2Picks()) m_team2ListWidget->addItem(b);
-        QStringList bansSorted = ds.bans().values();
-        std::sort(bansSorted.begin(), bansSorted.end());
-        m_bansListWidget->addItems(bansSorted);
+        showDraftLists(ds);
 
         bool isComplete = ds.isComplete();
-        QString turnText = isComplete ? "Complete" : ds.currentTurn();
-        m_turnLabel->setText(QString("Turn: %1").arg(turnText));
-        QString pickText = (ds.currentPickNumber() <= 6) ? QString::number(ds.currentPickNumber()) : "Done";
-        m_pickNumLabel->setText(QString("Pick #: %1").arg(pickText));
 
         // --- Button State Logic ---
-        bool canPickT1 = !isComplete && ds.currentTurn() == "team1" && ds.team1Picks().size() < 3;
-        bool canPickT2 = !isComplete && ds.currentTurn() == "team2" && ds.team2Picks().size() < 3;
-        bool canBan = !isComplete && ds.bans().size() < 6;
+        bool canPickT1 = !isComplete && ds.currentTurn() == DraftState::Turn::Team1 && ds.pickCount(DraftState::Turn::Team1) < DraftState::TEAM_SIZE;
+        bool canPickT2 = !isComplete && ds.currentTurn() == DraftState::Turn::Team2 && ds.pickCount(DraftState::Turn::Team2) < DraftState::TEAM_SIZE;
+        bool canBan = !isComplete && ds.banCount() < DraftState::MAX_BANS;
         bool canUnban = !ds.bans().isEmpty();
         // Allow undo unless it's the very beginning
         bool canUndoPick = ds.currentPickNumber() > 1;
@@ -794,15 +724,7 @@ void MainWindow::updateUiFromState() {
     } else if (mctsRunning) {
          // Update lists based on state *before* MCTS started
          if(m_currentDraftState) {
-            updateAvailableListDisplay();
-            for (const auto& b : m_currentDraftState->team1Picks()) m_team1ListWidget->addItem(b);
-            for (const auto& b : m_currentDraftState->team2Picks()) m_team2ListWidget->addItem(b);
-            QStringList bansSorted = m_currentDraftState->bans().values(); std::sort(bansSorted.begin(), bansSorted.end());
-            m_bansListWidget->addItems(bansSorted);
-            QString turnText = m_currentDraftState->isComplete() ? "Complete" : m_currentDraftState->currentTurn();
-            m_turnLabel->setText(QString("Turn: %1").arg(turnText));
-            QString pickText = (m_currentDraftState->currentPickNumber() <= 6) ? QString::number(m_currentDraftState->currentPickNumber()) : "Done";
-            m_pickNumLabel->setText(QString("Pick #: %1").arg(pickText));
+            showDraftLists(*m_currentDraftState);
          }
          // Controls are disabled by setControlsEnabled(false)
 
@@ -823,17 +745,34 @@ void MainWindow::updateUiFromState() {
 }
 
 
+// Team, ban and available lists plus the turn labels (lists cleared by the caller)
+void MainWindow::showDraftLists(const DraftState& ds) {
+    const BrawlerRegistry& registry = m_statsView.brawlerRegistry();
+    updateAvailableListDisplay();
+
+    for (BrawlerId id : ds.teamPicks(DraftState::Turn::Team1)) m_team1ListWidget->addItem(registry.nameOf(id));
+    for (BrawlerId id : ds.teamPicks(DraftState::Turn::Team2)) m_team2ListWidget->addItem(registry.nameOf(id));
+    ds.bans().forEach([&](BrawlerId id) { m_bansListWidget->addItem(registry.nameOf(id)); }); // Ascending IDs = sorted
+
+    QString turnText = ds.isComplete() ? "Complete" : DraftState::turnName(ds.currentTurn());
+    m_turnLabel->setText(QString("Turn: %1").arg(turnText));
+    QString pickText = (ds.currentPickNumber() <= DraftState::TOTAL_PICKS) ? QString::number(ds.currentPickNumber()) : "Done";
+    m_pickNumLabel->setText(QString("Pick #: %1").arg(pickText));
+}
+
 void MainWindow::updateAvailableListDisplay() {
     m_availableListWidget->clear();
     if (m_currentDraftState) {
+        const BrawlerRegistry& registry = m_statsView.brawlerRegistry();
         QString searchTerm = m_searchLineEdit->text().trimmed().toLower();
-        QVector<QString> available = m_currentDraftState->getLegalMoves();
 
-        for (const QString& brawler : available) {
+        // Available brawlers in ID order, which is alphabetical
+        m_currentDraftState->available().forEach([&](BrawlerId id) {
+            const QString& brawler = registry.nameOf(id);
             if (searchTerm.isEmpty() || brawler.toLower().contains(searchTerm)) {
                 m_availableListWidget->addItem(brawler);
             }
-        }
+        });
     }
 }
 
@@ -846,6 +785,7 @@ void MainWindow::setControlsEnabled(bool enabled) {
     m_modeComboBox->setEnabled(enabled);
     m_mapComboBox->setEnabled(enabled);
     m_mctsTimeLineEdit->setEnabled(enabled);
+    m_rankFloorLineEdit->setEnabled(enabled);
     // Enable reset only if draft is possible (mode/map selected) or active
     m_resetButton->setEnabled(enabled && (!m_modeComboBox->currentText().isEmpty() && !m_mapComboBox->currentText().isEmpty()));
 
@@ -950,8 +890,10 @@ void MainWindow::displayBanScores(const QVector<QString>& suggestedBans) {
 
      QVector<QPair<QString, double>> banDetails;
      if(m_currentDraftState){
+         const QString map = m_statsView.mapName(m_currentDraftState->mapModeId());
+         const QString mode = m_statsView.modeName(m_currentDraftState->mapModeId());
          for(const QString& brawler : suggestedBans) {
-              double wr = m_statsCalculator.getWinRate(brawler, m_currentDraftState->mapName(), m_currentDraftState->modeName())
+              double wr = m_statsView.getWinRate(brawler, map, mode)
                             .value_or(m_config.lowConfidenceWinRateTarget());
               banDetails.append({brawler, wr});
          }
@@ -11,7 +11,7 @@
 
 #include "DataStructures.h"
 #include "DraftState.h"
-#include "StatsCalculator.h"
+#include "StatsView.h"
 #include "AppConfig.h"
 #include "MCTS.h"
 
@@ -31,8 +31,7 @@ class MainWindow : public QMainWindow {
     Q_OBJECT
 
 public:
-    MainWindow(const StatsCalculator& statsCalculator, // Pass dependencies
-               const QSet<QString>& allBrawlers,
+    MainWindow(StatsView& statsView, // Pass dependencies (brawler list = its registry)
                const QHash<QString, QSet<QString>>& mapModeData,
                AppConfig& config, // Mutable config to save changes
                MCTSManager* mctsManager, // Pass manager pointer
@@ -48,6 +47,7 @@ private slots:
     void onMapChanged(int index);
     void onResetDraftClicked();
     void validateMctsTimeInput(); // Slot for QLineEdit editingFinished or similar
+    void validateRankFloorInput(); // Re-filters the stats to the new rank floor
 
     // Draft Action Slots
     void onPickTeam1Clicked();
@@ -80,6 +80,8 @@ private:
     void initializeDraft(); // Resets internal state and UI for new draft
     void updateUiFromState(); // Updates all lists, labels, button states
     void updateAvailableListDisplay(); // Updates the available list based on search and state
+    void showDraftLists(const DraftState& ds); // Team/ban/available lists and turn labels
+    void pickForTeam(DraftState::Turn team); // Picks the selected brawler for 'team'
     void setControlsEnabled(bool enabled); // Enables/disables UI elements during MCTS etc.
     void setStatus(const QString& text, bool isError = false, bool clearSuggestion = false);
     void clearSuggestionDisplay();
@@ -95,8 +97,7 @@ private:
 
 
     // Dependencies (passed in constructor)
-    const StatsCalculator& m_statsCalculator;
-    const QSet<QString>& m_allBrawlersMasterList;
+    StatsView& m_statsView; // Non-const only for setRankWindow
     const QHash<QString, QSet<QString>>& m_mapModeData;
     AppConfig& m_config; // Mutable reference
     MCTSManager* m_mctsManager; // Pointer to manager
@@ -108,6 +109,7 @@ private:
     QComboBox *m_modeComboBox;
     QComboBox *m_mapComboBox;
     QLineEdit *m_mctsTimeLineEdit;
+    QLineEdit *m_rankFloorLineEdit;
     QPushButton *m_resetButton;
 
     // Weights Frame REMOVED
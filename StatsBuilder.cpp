@@ -0,0 +1,670 @@
+#include "StatsBuilder.h"
+#include "DataStructures.h"
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+#include <cmath>     // For std::max, std::min
+#include <numeric>   // For std::accumulate if needed
+#include <algorithm> // For std::sort
+
+// Constructor for calculating from games
+StatsBuilder::StatsBuilder(const GameTable& games, const QSet<QString>& allBrawlers, const ConfigSnapshot& config)
+    : m_config(config)
+{
+    // Every brawler in the table gets an ID, even if missing from allBrawlers
+    QSet<QString> names = allBrawlers;
+    for (const QString& name : games.brawlers().names()) names.insert(name);
+    m_registry = BrawlerRegistry(names);
+
+    if (!games.isEmpty()) {
+        calculateStats(games);
+        qInfo() << "Statistics calculation complete.";
+    } else {
+         qInfo() << "StatsBuilder initialized without games to process immediately.";
+    }
+}
+
+// Constructor for loading from cache (or empty)
+StatsBuilder::StatsBuilder(const ConfigSnapshot& config)
+    : m_config(config)
+{
+     qDebug() << "StatsBuilder initialized empty (cache loading or streaming ingest).";
+}
+
+
+void StatsBuilder::calculateStats(const GameTable& games) {
+    qInfo() << "Calculating rank-weighted statistics from" << games.size() << "games...";
+    // QElapsedTimer timer; timer.start(); // For timing
+
+    m_stats.clear(); // Clear previous stats
+    if (games.isEmpty()) return;
+
+    // Table brawler IDs -> registry IDs, resolved once instead of per game
+    QVector<BrawlerId> idMap(games.brawlers().size());
+    for (int i = 0; i < idMap.size(); ++i) {
+        idMap[i] = m_registry.add(games.brawlers().nameOf(static_cast<BrawlerId>(i)));
+    }
+
+    // Shard layout depends only on the game count (never on the thread count),
+    // so the floating point summation order and the result are deterministic.
+    const qsizetype gameCount = games.size();
+    const qsizetype shardCount = std::clamp<qsizetype>(gameCount / MIN_GAMES_PER_SHARD, 1, MAX_STATS_SHARDS);
+    const qsizetype gamesPerShard = (gameCount + shardCount - 1) / shardCount;
+
+    struct ShardTask {
+        qsizetype begin = 0;
+        qsizetype end = 0;
+        QHash<quint32, MapModeStats> byMapMode; // (table map id << 16) | table mode id
+        StatsShard stats;
+    };
+    QVector<ShardTask> shards(shardCount);
+    for (qsizetype i = 0; i < shardCount; ++i) {
+        shards[i].begin = i * gamesPerShard;
+        shards[i].end = std::min(gameCount, shards[i].begin + gamesPerShard);
+    }
+
+    // 1. Each worker scans its slice of the columns into thread-local accumulators
+    QtConcurrent::blockingMap(shards, [this, &games, &idMap](ShardTask& shard) {
+        const quint16* mapIds = games.mapIds();
+        const quint16* modeIds = games.modeIds();
+        const BrawlerId* brawlerIds = games.brawlerIds();
+        const quint8* ranks = games.ranks();
+        QVector<PlayerIdData> winners(GameTable::TEAM_SIZE), losers(GameTable::TEAM_SIZE); // Reused, no per-game allocation
+        MapModeStats* current = nullptr;
+        quint32 currentKey = 0;
+
+        for (qsizetype g = shard.begin; g < shard.end; ++g) {
+            const quint32 key = (quint32(mapIds[g]) << 16) | modeIds[g];
+            if (!current || key != currentKey) { // Games of one map/mode often come in runs
+                current = &shard.byMapMode[key];
+                currentKey = key;
+            }
+            const qsizetype row = g * GameTable::PLAYERS_PER_GAME;
+            for (int i = 0; i < GameTable::TEAM_SIZE; ++i) {
+                winners[i] = {idMap[brawlerIds[row + i]], ranks[row + i]};
+                losers[i] = {idMap[brawlerIds[row + GameTable::TEAM_SIZE + i]], ranks[row + GameTable::TEAM_SIZE + i]};
+            }
+            accumulateGame(*current, winners, losers);
+        }
+
+        for (auto it = shard.byMapMode.begin(); it != shard.byMapMode.end(); ++it) {
+            const QString& mapName = games.mapNames()[it.key() >> 16];
+            const QString& modeName = games.modeNames()[it.key() & 0xFFFF];
+            shard.stats[mapName][modeName] = std::move(it.value());
+        }
+        shard.byMapMode.clear();
+    });
+
+    // 2. Pairwise tree reduction: round r merges shard i + 2^r into shard i.
+    // The pairing is fixed, so every run adds the partial sums in the same order.
+    for (qsizetype stride = 1; stride < shardCount; stride *= 2) {
+        QVector<qsizetype> targets;
+        for (qsizetype i = 0; i + stride < shardCount; i += 2 * stride) {
+            targets.append(i);
+        }
+        QtConcurrent::blockingMap(targets, [&shards, stride](qsizetype target) {
+            mergeShard(shards[target].stats, shards[target + stride].stats);
+            shards[target + stride].stats.clear(); // Free merged shard early
+        });
+    }
+
+    m_stats = std::move(shards[0].stats);
+    // qInfo() << "Statistics calculation took" << timer.elapsed() << "ms";
+}
+
+
+void StatsBuilder::accumulateGame(MapModeStats& currentMapModeStats, const QVector<PlayerIdData>& winners, const QVector<PlayerIdData>& losers) const {
+    // Update Brawler Wins/Plays and Total Plays
+    double gameTotalWeightContribution = 0; // Track weight added by this game to total plays
+
+    // Winners
+    for (const auto& playerData : winners) {
+        double weight = m_config.getRankWeight(playerData.rank);
+        BrawlerStats& bStats = currentMapModeStats.brawlerStats[playerData.id]; // Creates if new
+        bStats.wins += weight;
+        bStats.plays += weight;
+        gameTotalWeightContribution += weight;
+        RankCounts& counts = currentMapModeStats.rankCounts[playerData.id];
+        counts.wins[RankCounts::bucket(playerData.rank)]++;
+        counts.plays[RankCounts::bucket(playerData.rank)]++;
+    }
+    // Losers
+    for (const auto& playerData : losers) {
+        double weight = m_config.getRankWeight(playerData.rank);
+        BrawlerStats& bStats = currentMapModeStats.brawlerStats[playerData.id]; // Creates if new
+        // No wins update for losers
+        bStats.plays += weight;
+        gameTotalWeightContribution += weight;
+        currentMapModeStats.rankCounts[playerData.id].plays[RankCounts::bucket(playerData.rank)]++;
+    }
+    currentMapModeStats.totalWeightedPlays += gameTotalWeightContribution;
+
+
+    // Update Synergy Stats
+    updateTeamSynergy(currentMapModeStats, winners, true);
+    updateTeamSynergy(currentMapModeStats, losers, false);
+
+    // Update Counter Stats
+    for (const auto& winnerData : winners) {
+        double weightWin = m_config.getRankWeight(winnerData.rank);
+        for (const auto& loserData : losers) {
+             double weightLose = m_config.getRankWeight(loserData.rank);
+
+            // Winner vs Loser perspective (Winner wins the matchup)
+            BrawlerStats& cStatsWin = currentMapModeStats.counterStats[counterPairKey(winnerData.id, loserData.id)];
+            cStatsWin.wins += weightWin;
+            cStatsWin.plays += weightWin;
+
+            // Loser vs Winner perspective (Loser plays the matchup)
+            BrawlerStats& cStatsLose = currentMapModeStats.counterStats[counterPairKey(loserData.id, winnerData.id)];
+            // Loser only contributes play count from their perspective
+            cStatsLose.plays += weightLose;
+        }
+    }
+}
+
+
+void StatsBuilder::addGame(const ProcessedGame& game) {
+    auto intern = [this](const QVector<PlayerData>& teamData) {
+        QVector<PlayerIdData> ids;
+        ids.reserve(teamData.size());
+        for (const PlayerData& p : teamData) {
+            BrawlerId id = m_registry.add(p.brawlerName);
+            if (id != INVALID_BRAWLER_ID) ids.append({id, p.rank});
+        }
+        return ids;
+    };
+    accumulateGame(m_stats[game.map][game.mode], intern(game.winningTeamData), intern(game.losingTeamData));
+}
+
+void StatsBuilder::finishIngest(const QSet<QString>& allBrawlers) {
+    const QVector<QString>& names = m_registry.names();
+    QSet<QString> everyName = allBrawlers;
+    everyName.unite(QSet<QString>(names.begin(), names.end()));
+    BrawlerRegistry sorted(everyName);
+
+    QVector<BrawlerId> newIds(names.size());
+    bool unchanged = true;
+    for (int id = 0; id < names.size(); ++id) {
+        newIds[id] = sorted.idOf(names[id]);
+        unchanged = unchanged && newIds[id] == id;
+    }
+    m_registry = std::move(sorted);
+    if (unchanged) return;
+
+    for (auto mapIt = m_stats.begin(); mapIt != m_stats.end(); ++mapIt) {
+        for (auto modeIt = mapIt.value().begin(); modeIt != mapIt.value().end(); ++modeIt) {
+            remapIds(modeIt.value(), newIds);
+        }
+    }
+}
+
+void StatsBuilder::mergeFrom(const StatsBuilder& other) {
+    m_hasRankCounts = m_hasRankCounts && other.m_hasRankCounts;
+    QVector<BrawlerId> newIds(other.m_registry.size());
+    bool sameIds = true;
+    for (int id = 0; id < newIds.size(); ++id) {
+        newIds[id] = m_registry.add(other.m_registry.nameOf(static_cast<BrawlerId>(id)));
+        sameIds = sameIds && newIds[id] == id;
+    }
+    if (sameIds) {
+        mergeShard(m_stats, other.m_stats);
+        return;
+    }
+
+    StatsShard remapped = other.m_stats;
+    for (auto mapIt = remapped.begin(); mapIt != remapped.end(); ++mapIt) {
+        for (auto modeIt = mapIt.value().begin(); modeIt != mapIt.value().end(); ++modeIt) {
+            remapIds(modeIt.value(), newIds);
+        }
+    }
+    mergeShard(m_stats, remapped);
+}
+
+// Rewrites every key of one accumulator through newIds (old id -> new id)
+void StatsBuilder::remapIds(MapModeStats& stats, const QVector<BrawlerId>& newIds) {
+    QHash<BrawlerId, BrawlerStats> brawlerStats;
+    brawlerStats.reserve(stats.brawlerStats.size());
+    for (auto it = stats.brawlerStats.constBegin(); it != stats.brawlerStats.constEnd(); ++it) {
+        brawlerStats.insert(newIds[it.key()], it.value());
+    }
+    stats.brawlerStats = std::move(brawlerStats);
+
+    QHash<BrawlerId, RankCounts> rankCounts;
+    rankCounts.reserve(stats.rankCounts.size());
+    for (auto it = stats.rankCounts.constBegin(); it != stats.rankCounts.constEnd(); ++it) {
+        rankCounts.insert(newIds[it.key()], it.value());
+    }
+    stats.rankCounts = std::move(rankCounts);
+
+    // Synergy keys are re-sorted: the lower ID has to come first again
+    QHash<quint32, BrawlerStats> synergyStats;
+    synergyStats.reserve(stats.synergyStats.size());
+    for (auto it = stats.synergyStats.constBegin(); it != stats.synergyStats.constEnd(); ++it) {
+        synergyStats.insert(sortedPairKey(newIds[pairKeyFirst(it.key())], newIds[pairKeySecond(it.key())]), it.value());
+    }
+    stats.synergyStats = std::move(synergyStats);
+
+    QHash<quint32, BrawlerStats> counterStats;
+    counterStats.reserve(stats.counterStats.size());
+    for (auto it = stats.counterStats.constBegin(); it != stats.counterStats.constEnd(); ++it) {
+        counterStats.insert(counterPairKey(newIds[pairKeyFirst(it.key())], newIds[pairKeySecond(it.key())]), it.value());
+    }
+    stats.counterStats = std::move(counterStats);
+}
+
+
+// Adds every accumulator in 'from' into 'into'
+void StatsBuilder::mergeShard(StatsShard& into, const StatsShard& from) {
+    auto mergeEntries = [](auto& target, const auto& source) {
+        for (auto it = source.constBegin(); it != source.constEnd(); ++it) {
+            BrawlerStats& t = target[it.key()];
+            t.wins += it.value().wins;
+            t.plays += it.value().plays;
+        }
+    };
+
+    for (auto mapIt = from.constBegin(); mapIt != from.constEnd(); ++mapIt) {
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            const MapModeStats& source = modeIt.value();
+            MapModeStats& target = into[mapIt.key()][modeIt.key()];
+            target.totalWeightedPlays += source.totalWeightedPlays;
+            mergeEntries(target.brawlerStats, source.brawlerStats);
+            mergeEntries(target.synergyStats, source.synergyStats);
+            mergeEntries(target.counterStats, source.counterStats);
+            for (auto it = source.rankCounts.constBegin(); it != source.rankCounts.constEnd(); ++it) {
+                target.rankCounts[it.key()].add(it.value());
+            }
+        }
+    }
+}
+
+void StatsBuilder::setStatsFromCacheData(const CacheData& cacheData) {
+     qInfo() << "Loading stats from cache data...";
+     m_stats.clear();
+     m_registry = BrawlerRegistry(cacheData.allBrawlers);
+     m_hasRankCounts = cacheData.hasRankCounts;
+
+     // Splits a cached "A|B" key into packed IDs; returns false for unknown names
+     auto parsePairKey = [this](const QString& key, BrawlerId& first, BrawlerId& second) {
+         qsizetype sep = key.indexOf('|');
+         if (sep < 0) return false;
+         first = m_registry.idOf(key.left(sep));
+         second = m_registry.idOf(key.mid(sep + 1));
+         return first != INVALID_BRAWLER_ID && second != INVALID_BRAWLER_ID;
+     };
+     int skippedKeys = 0;
+
+     // Convert name-keyed CacheData structures to id-keyed MapModeStats
+     for (auto mapIt = cacheData.stats.constBegin(); mapIt != cacheData.stats.constEnd(); ++mapIt) {
+         const QString& mapName = mapIt.key();
+         for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+             const QString& modeName = modeIt.key();
+             const MapModeStatsData& sourceData = modeIt.value();
+             MapModeStats& targetStats = m_stats[mapName][modeName]; // Create target entry
+
+             targetStats.totalWeightedPlays = sourceData.totalWeightedPlays;
+
+             // Convert brawler stats
+             for(auto bsIt = sourceData.brawlerStats.constBegin(); bsIt != sourceData.brawlerStats.constEnd(); ++bsIt) {
+                 BrawlerId id = m_registry.idOf(bsIt.key());
+                 if (id == INVALID_BRAWLER_ID) { skippedKeys++; continue; }
+                 targetStats.brawlerStats[id].wins = bsIt.value().wins;
+                 targetStats.brawlerStats[id].plays = bsIt.value().plays;
+             }
+             if (m_hasRankCounts) {
+                 for (auto rcIt = sourceData.rankCounts.constBegin(); rcIt != sourceData.rankCounts.constEnd(); ++rcIt) {
+                     BrawlerId id = m_registry.idOf(rcIt.key());
+                     if (id == INVALID_BRAWLER_ID) { skippedKeys++; continue; }
+                     targetStats.rankCounts.insert(id, rcIt.value());
+                 }
+             }
+             // Convert synergy stats
+             for(auto ssIt = sourceData.synergyStats.constBegin(); ssIt != sourceData.synergyStats.constEnd(); ++ssIt) {
+                 BrawlerId b1, b2;
+                 if (!parsePairKey(ssIt.key(), b1, b2)) { skippedKeys++; continue; }
+                 BrawlerStats& pairStats = targetStats.synergyStats[sortedPairKey(b1, b2)];
+                 pairStats.wins = ssIt.value().wins;
+                 pairStats.plays = ssIt.value().plays;
+             }
+             // Convert counter stats
+             for(auto csIt = sourceData.counterStats.constBegin(); csIt != sourceData.counterStats.constEnd(); ++csIt) {
+                 BrawlerId bUs, bThem;
+                 if (!parsePairKey(csIt.key(), bUs, bThem)) { skippedKeys++; continue; }
+                 BrawlerStats& matchupStats = targetStats.counterStats[counterPairKey(bUs, bThem)];
+                 matchupStats.wins = csIt.value().wins;
+                 matchupStats.plays = csIt.value().plays;
+             }
+         }
+     }
+     if (skippedKeys > 0) qWarning() << "Skipped" << skippedKeys << "cache entries referencing unknown brawlers.";
+     qInfo() << "Stats loaded into builder for" << m_registry.size() << "brawlers.";
+}
+
+
+CacheData StatsBuilder::getStatsForCache() const {
+    qInfo() << "Preparing stats data for caching...";
+    CacheData cacheData;
+
+    // Convert id-keyed MapModeStats to name-keyed CacheData structures
+    for (auto mapIt = m_stats.constBegin(); mapIt != m_stats.constEnd(); ++mapIt) {
+        const QString& mapName = mapIt.key();
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            const QString& modeName = modeIt.key();
+            const MapModeStats& sourceStats = modeIt.value();
+            MapModeStatsData& targetData = cacheData.stats[mapName][modeName]; // Create target entry
+
+            targetData.totalWeightedPlays = sourceStats.totalWeightedPlays;
+
+            // Convert brawler stats (IDs back to names for the cache format)
+            for(auto bsIt = sourceStats.brawlerStats.constBegin(); bsIt != sourceStats.brawlerStats.constEnd(); ++bsIt) {
+                BrawlerStatsData& target = targetData.brawlerStats[m_registry.nameOf(bsIt.key())];
+                target.wins = bsIt.value().wins;
+                target.plays = bsIt.value().plays;
+            }
+            for (auto rcIt = sourceStats.rankCounts.constBegin(); rcIt != sourceStats.rankCounts.constEnd(); ++rcIt) {
+                targetData.rankCounts.insert(m_registry.nameOf(rcIt.key()), rcIt.value());
+            }
+             // Convert synergy stats
+            for(auto ssIt = sourceStats.synergyStats.constBegin(); ssIt != sourceStats.synergyStats.constEnd(); ++ssIt) {
+                QString key = sortedPairKey(m_registry.nameOf(pairKeyFirst(ssIt.key())), m_registry.nameOf(pairKeySecond(ssIt.key())));
+                targetData.synergyStats[key].wins = ssIt.value().wins;
+                targetData.synergyStats[key].plays = ssIt.value().plays;
+            }
+             // Convert counter stats
+            for(auto csIt = sourceStats.counterStats.constBegin(); csIt != sourceStats.counterStats.constEnd(); ++csIt) {
+                QString key = counterPairKey(m_registry.nameOf(pairKeyFirst(csIt.key())), m_registry.nameOf(pairKeySecond(csIt.key())));
+                targetData.counterStats[key].wins = csIt.value().wins;
+                targetData.counterStats[key].plays = csIt.value().plays;
+            }
+        }
+    }
+    cacheData.allBrawlers = QSet<QString>(m_registry.names().begin(), m_registry.names().end());
+    cacheData.hasRankCounts = m_hasRankCounts;
+    qInfo() << "Stats data prepared for caching.";
+    return cacheData; // RVO should handle this efficiently
+}
+
+
+// Helper to update synergy stats for a team
+void StatsBuilder::updateTeamSynergy(MapModeStats& mapModeStats, const QVector<PlayerIdData>& teamData, bool win) const {
+    for (int i = 0; i < teamData.size(); ++i) {
+        const PlayerIdData& p1 = teamData[i];
+        for (int j = i + 1; j < teamData.size(); ++j) {
+            const PlayerIdData& p2 = teamData[j];
+
+            // Use average rank for weighting synergy pairs
+            double avgRank = (static_cast<double>(p1.rank) + p2.rank) / 2.0;
+            double weight = m_config.getRankWeight(static_cast<int>(round(avgRank)));
+
+            BrawlerStats& pairStats = mapModeStats.synergyStats[sortedPairKey(p1.id, p2.id)]; // Creates if new
+            if (win) {
+                pairStats.wins += weight;
+            }
+            pairStats.plays += weight;
+        }
+    }
+}
+
+
+// --- Raw computations (table building only) ---
+
+double StatsBuilder::computeWinRate(BrawlerId brawler, const MapModeStats& stats) const {
+    auto brawlerIt = stats.brawlerStats.constFind(brawler);
+    if (brawlerIt == stats.brawlerStats.constEnd()) {
+        // Brawler not found in stats for this map/mode, apply low confidence target
+        return m_config.lowConfidenceWinRateTarget;
+    }
+
+    std::optional<double> pickRateOpt = computePickRate(brawler, stats);
+    double pickRate = pickRateOpt.value_or(0.0); // Use 0.0 if pick rate couldn't be calculated
+
+    return StatsView::adjustedWinRate(brawlerIt->wins, brawlerIt->plays, pickRate, m_config.smoothingK,
+                                      m_config.lowPickRateThreshold, m_config.lowConfidenceWinRateTarget);
+}
+
+
+std::optional<double> StatsBuilder::computePickRate(BrawlerId brawler, const MapModeStats& stats) const {
+    double totalPlays = stats.totalWeightedPlays;
+    if (totalPlays <= 0) {
+        return std::nullopt; // No plays for this map/mode
+    }
+
+    auto brawlerIt = stats.brawlerStats.constFind(brawler);
+    double brawlerPlays = 0.0;
+    if (brawlerIt != stats.brawlerStats.constEnd()) {
+        brawlerPlays = brawlerIt->plays;
+    }
+
+    return brawlerPlays / totalPlays;
+}
+
+
+// Smoothed win rate for a synergy pair or counter matchup
+double StatsBuilder::computeSmoothedScore(const BrawlerStats& pairStats) const {
+    double plays = pairStats.plays;
+    double wins = pairStats.wins;
+    double k = m_config.smoothingK; // Use same smoothing as win rate
+
+    if (plays + k <= 0) {
+        return 0.5; // Avoid division by zero or meaningless result
+    }
+
+    return std::max(0.0, std::min(1.0, (wins + k * 0.5) / (plays + k)));
+}
+
+
+// Writes the derived score tables for one map/mode (layout: see StatsPack.h)
+void StatsBuilder::fillTables(const MapModeStats& stats, char* dest) const {
+    const int n = m_registry.size();
+    double* winRates = reinterpret_cast<double*>(dest);
+    double* pickRates = winRates + n;
+    float* synergy = reinterpret_cast<float*>(pickRates + n);
+    float* counter = synergy + qint64(n) * n;
+
+    for (int id = 0; id < n; ++id) {
+        winRates[id] = computeWinRate(static_cast<BrawlerId>(id), stats);
+        pickRates[id] = computePickRate(static_cast<BrawlerId>(id), stats).value_or(0.0);
+    }
+
+    // Pairs without data keep the neutral 0.5
+    std::fill(synergy, synergy + qint64(n) * n, 0.5f);
+    for (auto it = stats.synergyStats.constBegin(); it != stats.synergyStats.constEnd(); ++it) {
+        BrawlerId a = pairKeyFirst(it.key());
+        BrawlerId b = pairKeySecond(it.key());
+        float score = static_cast<float>(computeSmoothedScore(it.value()));
+        synergy[a * n + b] = score;
+        synergy[b * n + a] = score;
+    }
+
+    std::fill(counter, counter + qint64(n) * n, 0.5f);
+    for (auto it = stats.counterStats.constBegin(); it != stats.counterStats.constEnd(); ++it) {
+        counter[pairKeyFirst(it.key()) * n + pairKeySecond(it.key())] =
+            static_cast<float>(computeSmoothedScore(it.value()));
+    }
+}
+
+// Writes the raw wins/plays for one map/mode as dense arrays (zero = no data)
+void StatsBuilder::fillRaw(const MapModeStats& stats, char* dest) const {
+    const int n = m_registry.size();
+    double* brawlerWins = reinterpret_cast<double*>(dest);
+    double* brawlerPlays = brawlerWins + n;
+    double* synergyWins = brawlerPlays + n;
+    double* synergyPlays = synergyWins + qint64(n) * n;
+    double* counterWins = synergyPlays + qint64(n) * n;
+    double* counterPlays = counterWins + qint64(n) * n;
+
+    for (auto it = stats.brawlerStats.constBegin(); it != stats.brawlerStats.constEnd(); ++it) {
+        brawlerWins[it.key()] = it.value().wins;
+        brawlerPlays[it.key()] = it.value().plays;
+    }
+    // sortedPairKey puts the lower id first, so synergy fills the upper triangle
+    for (auto it = stats.synergyStats.constBegin(); it != stats.synergyStats.constEnd(); ++it) {
+        qint64 cell = qint64(pairKeyFirst(it.key())) * n + pairKeySecond(it.key());
+        synergyWins[cell] = it.value().wins;
+        synergyPlays[cell] = it.value().plays;
+    }
+    for (auto it = stats.counterStats.constBegin(); it != stats.counterStats.constEnd(); ++it) {
+        qint64 cell = qint64(pairKeyFirst(it.key())) * n + pairKeySecond(it.key());
+        counterWins[cell] = it.value().wins;
+        counterPlays[cell] = it.value().plays;
+    }
+}
+
+
+// Writes the unweighted per-rank counts for one map/mode (zero = no games)
+void StatsBuilder::fillRankCounts(const MapModeStats& stats, char* dest) const {
+    const int n = m_registry.size();
+    quint32* wins = reinterpret_cast<quint32*>(dest);
+    quint32* plays = wins + qint64(n) * RankCounts::BUCKETS;
+
+    for (auto it = stats.rankCounts.constBegin(); it != stats.rankCounts.constEnd(); ++it) {
+        const qint64 row = qint64(it.key()) * RankCounts::BUCKETS;
+        std::copy(it.value().wins, it.value().wins + RankCounts::BUCKETS, wins + row);
+        std::copy(it.value().plays, it.value().plays + RankCounts::BUCKETS, plays + row);
+    }
+}
+
+
+AlignedVector<char> StatsBuilder::buildPackImage(const QHash<QString, QSet<QString>>& discoveredMapModes,
+                                                 const CacheMetadata& metadata) const {
+    const int n = m_registry.size();
+
+    // Directory: every map/mode with stats plus discovered ones without games,
+    // sorted so the same stats always produce the same bytes
+    QVector<QPair<QString, QString>> mapModes;
+    for (auto mapIt = m_stats.constBegin(); mapIt != m_stats.constEnd(); ++mapIt) {
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            mapModes.append({mapIt.key(), modeIt.key()});
+        }
+    }
+    for (auto modeIt = discoveredMapModes.constBegin(); modeIt != discoveredMapModes.constEnd(); ++modeIt) {
+        for (const QString& mapName : modeIt.value()) {
+            if (!m_stats.value(mapName).contains(modeIt.key())) mapModes.append({mapName, modeIt.key()});
+        }
+    }
+    std::sort(mapModes.begin(), mapModes.end());
+    QVector<QPair<QString, qint64>> sources;
+    for (auto it = metadata.ingestedOffsets.constBegin(); it != metadata.ingestedOffsets.constEnd(); ++it) {
+        sources.append({it.key(), it.value()});
+    }
+    std::sort(sources.begin(), sources.end());
+
+    // String table: brawler names first so string index == BrawlerId
+    QVector<QByteArray> strings;
+    QHash<QString, quint32> stringIds;
+    auto intern = [&](const QString& s) {
+        auto it = stringIds.constFind(s);
+        if (it != stringIds.constEnd()) return it.value();
+        quint32 id = static_cast<quint32>(strings.size());
+        strings.append(s.toUtf8());
+        stringIds.insert(s, id);
+        return id;
+    };
+    for (const QString& name : m_registry.names()) intern(name);
+    for (const auto& mm : mapModes) { intern(mm.first); intern(mm.second); }
+    for (const auto& src : sources) intern(src.first);
+
+    qint64 stringBytes = 0;
+    for (const QByteArray& s : strings) stringBytes += s.size();
+
+    // Section offsets
+    using Pack = StatsPack;
+    const qint64 stringIndexOffset = Pack::align(sizeof(Pack::Header));
+    const qint64 stringDataOffset = stringIndexOffset + qint64(strings.size()) * qint64(sizeof(Pack::StringRef));
+    const qint64 directoryOffset = Pack::align(stringDataOffset + stringBytes);
+    const qint64 sourcesOffset = Pack::align(directoryOffset + qint64(mapModes.size()) * qint64(sizeof(Pack::DirEntry)));
+    const qint64 tocSize = Pack::align(sourcesOffset + qint64(sources.size()) * qint64(sizeof(Pack::SourceEntry)));
+    qint64 cursor = tocSize;
+
+    QVector<Pack::DirEntry> directory(mapModes.size());
+    QVector<const MapModeStats*> entryStats(mapModes.size(), nullptr);
+    for (int i = 0; i < mapModes.size(); ++i) {
+        Pack::DirEntry& e = directory[i];
+        e = Pack::DirEntry{};
+        e.mapString = stringIds.value(mapModes[i].first);
+        e.modeString = stringIds.value(mapModes[i].second);
+        const MapModeStats* stats = nullptr;
+        auto mapIt = m_stats.constFind(mapModes[i].first);
+        if (mapIt != m_stats.constEnd()) {
+            auto modeIt = mapIt.value().constFind(mapModes[i].second);
+            if (modeIt != mapIt.value().constEnd()) stats = &modeIt.value();
+        }
+        if (!stats) continue;
+        entryStats[i] = stats;
+        e.flags = Pack::HasStats;
+        e.totalWeightedPlays = stats->totalWeightedPlays;
+        e.tablesOffset = cursor; cursor += Pack::tablesSize(n);
+        e.rawOffset = cursor;    cursor += Pack::rawSize(n);
+        if (m_hasRankCounts) {
+            e.rankCountsOffset = cursor; cursor += Pack::rankCountsSize(n);
+        }
+    }
+
+    const qint64 fingerprintsOffset = cursor;
+    cursor += Pack::align(qint64(metadata.battleFingerprints.size()) * qint64(sizeof(quint64)));
+
+    // Fill the image (zero-initialized, so raw arrays start at "no data")
+    AlignedVector<char> image(static_cast<size_t>(cursor), 0);
+    char* base = image.data();
+
+    Pack::Header& header = *reinterpret_cast<Pack::Header*>(base);
+    header = Pack::Header{};
+    header.magic = Pack::MAGIC;
+    header.version = Pack::VERSION;
+    header.fileSize = static_cast<quint64>(cursor);
+    header.tocSize = static_cast<quint64>(tocSize);
+    header.brawlerCount = static_cast<quint32>(n);
+    header.stringCount = static_cast<quint32>(strings.size());
+    header.entryCount = static_cast<quint32>(mapModes.size());
+    header.sourceCount = static_cast<quint32>(sources.size());
+    header.stringIndexOffset = stringIndexOffset;
+    header.stringDataOffset = stringDataOffset;
+    header.directoryOffset = directoryOffset;
+    header.sourcesOffset = sourcesOffset;
+    header.fingerprintsOffset = fingerprintsOffset;
+    header.fingerprintCount = static_cast<quint64>(metadata.battleFingerprints.size());
+    header.cacheCreationTime = metadata.cacheCreationTime;
+    header.smoothingK = m_config.smoothingK;
+    header.lowPickRateThreshold = m_config.lowPickRateThreshold;
+    header.lowConfidenceWinRateTarget = m_config.lowConfidenceWinRateTarget;
+    header.minRank = m_config.minRank;
+    header.maxRankConsidered = m_config.maxRankConsidered;
+    header.rankWeightScaleDivisor = m_config.rankWeightScaleDivisor;
+    header.rankBuckets = m_hasRankCounts ? RankCounts::BUCKETS : 0;
+
+    Pack::StringRef* stringIndex = reinterpret_cast<Pack::StringRef*>(base + stringIndexOffset);
+    quint32 stringPos = 0;
+    for (int i = 0; i < strings.size(); ++i) {
+        stringIndex[i] = {stringPos, static_cast<quint32>(strings[i].size())};
+        std::copy(strings[i].constData(), strings[i].constData() + strings[i].size(), base + stringDataOffset + stringPos);
+        stringPos += static_cast<quint32>(strings[i].size());
+    }
+
+    std::copy(directory.constBegin(), directory.constEnd(), reinterpret_cast<Pack::DirEntry*>(base + directoryOffset));
+    Pack::SourceEntry* sourceEntries = reinterpret_cast<Pack::SourceEntry*>(base + sourcesOffset);
+    for (int i = 0; i < sources.size(); ++i) {
+        sourceEntries[i] = {stringIds.value(sources[i].first), 0, sources[i].second};
+    }
+
+    std::copy(metadata.battleFingerprints.constBegin(), metadata.battleFingerprints.constEnd(),
+              reinterpret_cast<quint64*>(base + fingerprintsOffset));
+
+    // Per map/mode arrays are independent, fill them in parallel
+    QVector<int> withStats;
+    for (int i = 0; i < directory.size(); ++i) {
+        if (entryStats[i]) withStats.append(i);
+    }
+    QtConcurrent::blockingMap(withStats, [&](int i) {
+        fillTables(*entryStats[i], base + directory[i].tablesOffset);
+        fillRaw(*entryStats[i], base + directory[i].rawOffset);
+        if (m_hasRankCounts) fillRankCounts(*entryStats[i], base + directory[i].rankCountsOffset);
+    });
+
+    qInfo() << "Built stats pack image:" << cursor << "bytes," << mapModes.size() << "map/modes," << n << "brawlers.";
+    return image;
+}
+
+
+StatsView StatsBuilder::buildView() const {
+    return StatsView(StatsPack::fromImage(buildPackImage({}, CacheMetadata{})));
+}
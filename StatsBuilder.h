@@ -0,0 +1,83 @@
+#ifndef STATSBUILDER_H
+#define STATSBUILDER_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <optional> // C++17 required
+#include "DataStructures.h"
+#include "BrawlerRegistry.h"
+#include "AppConfig.h"
+#include "StatsView.h"
+#include "StatsPack.h"
+#include "GameTable.h"
+
+// Mutable aggregation side of the stats. Only used while loading: accumulate
+// games (or load the cache), then call buildView() and drop the builder.
+// Not thread safe to call into (calculateStats parallelizes internally);
+// everything after load reads the immutable StatsView.
+class StatsBuilder {
+public:
+    // Constructor for calculating from games
+    StatsBuilder(const GameTable& games, const QSet<QString>& allBrawlers, const ConfigSnapshot& config);
+    // Constructor for loading from cache (or empty)
+    StatsBuilder(const ConfigSnapshot& config);
+
+
+    // Re-aggregates from scratch with one sequential scan of the game columns
+    void calculateStats(const GameTable& games);
+
+    // Streaming ingest: adds one game straight into the accumulators, so the
+    // caller never has to hold the games. New brawlers get IDs as they show up;
+    // call finishIngest() after the last game.
+    void addGame(const ProcessedGame& game);
+    // Registers 'allBrawlers' too (some only appear in dropped games), then
+    // renumbers alphabetically like the other constructors, so the same games
+    // give the same pack whatever order they arrived in
+    void finishIngest(const QSet<QString>& allBrawlers);
+    // Adds another (partial) ingest's accumulators; IDs are matched by name.
+    // Used to combine per-chunk builders from parallel ingest.
+    void mergeFrom(const StatsBuilder& other);
+
+    void setStatsFromCacheData(const CacheData& cacheData); // Load from name-keyed cache struct
+    CacheData getStatsForCache() const; // Get name-keyed data for saving
+
+    const BrawlerRegistry& brawlerRegistry() const { return m_registry; }
+
+    // Freezes the current stats into a stats.pack image (see StatsPack.h). Map/modes
+    // in 'discoveredMapModes' without games get directory entries without tables.
+    AlignedVector<char> buildPackImage(const QHash<QString, QSet<QString>>& discoveredMapModes,
+                                       const CacheMetadata& metadata) const;
+    // In-memory view over a fresh image (no file involved)
+    StatsView buildView() const;
+
+private:
+    // Raw computations from BrawlerStats; only used when building the pack
+    double computeWinRate(BrawlerId brawler, const MapModeStats& stats) const;
+    std::optional<double> computePickRate(BrawlerId brawler, const MapModeStats& stats) const;
+    double computeSmoothedScore(const BrawlerStats& pairStats) const;
+    void fillTables(const MapModeStats& stats, char* dest) const;
+    void fillRaw(const MapModeStats& stats, char* dest) const;
+    void fillRankCounts(const MapModeStats& stats, char* dest) const;
+
+    // Map -> Mode -> Stats, one per aggregation worker (see calculateStats)
+    using StatsShard = QHash<QString, QHash<QString, MapModeStats>>;
+    static constexpr qsizetype MIN_GAMES_PER_SHARD = 4096; // Below this a shard isn't worth a thread
+    static constexpr qsizetype MAX_STATS_SHARDS = 64;      // Caps memory held by partial results
+    struct PlayerIdData { BrawlerId id; int rank; };
+    void accumulateGame(MapModeStats& stats, const QVector<PlayerIdData>& winners, const QVector<PlayerIdData>& losers) const;
+    static void mergeShard(StatsShard& into, const StatsShard& from);
+    static void remapIds(MapModeStats& stats, const QVector<BrawlerId>& newIds);
+
+    void updateTeamSynergy(MapModeStats& mapModeStats, const QVector<PlayerIdData>& teamData, bool win) const;
+
+    ConfigSnapshot m_config; // Own copy, never reads QSettings
+    BrawlerRegistry m_registry;
+    bool m_hasRankCounts = true; // False after loading a cache without them (CacheData::hasRankCounts)
+    // Main storage: Map -> Mode -> Stats
+    // Use QHash for efficiency, outer key is map name, inner key is mode name
+    StatsShard m_stats;
+};
+
+#endif // STATSBUILDER_H
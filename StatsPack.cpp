@@ -0,0 +1,374 @@
+#include "StatsPack.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QDir>
+#include <stdexcept>
+#include <algorithm> // For std::copy
+
+qint64 StatsPack::tablesSize(int n) {
+    // winRates + pickRates (double), synergy + counter (float)
+    return align(2 * n * qint64(sizeof(double)) + 2 * qint64(n) * n * qint64(sizeof(float)));
+}
+
+qint64 StatsPack::rawSize(int n) {
+    // brawler wins/plays, synergy wins/plays, counter wins/plays (all double)
+    return align((2 * qint64(n) + 4 * qint64(n) * n) * qint64(sizeof(double)));
+}
+
+qint64 StatsPack::rankCountsSize(int n) {
+    // wins + plays per brawler and rank bucket
+    return align(2 * qint64(n) * RankCounts::BUCKETS * qint64(sizeof(quint32)));
+}
+
+
+std::shared_ptr<const StatsPack> StatsPack::map(const QString& filepath) {
+    auto file = std::make_unique<QFile>(filepath);
+    if (!file->exists()) {
+        qInfo() << "Stats pack not found:" << filepath;
+        return nullptr;
+    }
+    if (!file->open(QIODevice::ReadOnly)) {
+        qWarning() << "Error opening stats pack for reading:" << filepath << file->errorString();
+        return nullptr;
+    }
+
+    // Peek at the header to find out how much to map up front
+    qint64 size = file->size();
+    Header peek{};
+    if (size < qint64(sizeof(Header)) || file->read(reinterpret_cast<char*>(&peek), sizeof(Header)) != qint64(sizeof(Header))) {
+        qWarning() << "Stats pack too small to hold a header:" << filepath;
+        return nullptr;
+    }
+    if (peek.magic != MAGIC) {
+        qInfo() << "Not a mapped stats pack (magic mismatch):" << filepath;
+        return nullptr;
+    }
+    if (peek.version != VERSION || peek.tocSize < sizeof(Header) || peek.tocSize > quint64(size)) {
+        qWarning() << "Stats pack version mismatch or bad header (expected version" << VERSION << ", got" << peek.version << "):" << filepath;
+        return nullptr;
+    }
+
+    uchar* data = file->map(0, static_cast<qint64>(peek.tocSize));
+    if (!data) {
+        qWarning() << "Failed to memory-map stats pack:" << filepath << file->errorString();
+        return nullptr;
+    }
+
+    std::shared_ptr<StatsPack> pack(new StatsPack());
+    pack->m_data = reinterpret_cast<const char*>(data);
+    pack->m_size = size;
+    pack->m_file = std::move(file);
+    if (!pack->validate(filepath)) {
+        return nullptr; // Destructor unmaps
+    }
+    qInfo() << "Mapped stats pack" << filepath << "(" << pack->header().tocSize << "of" << size << "bytes," << pack->entryCount() << "map/modes)";
+    return pack;
+}
+
+std::shared_ptr<const StatsPack> StatsPack::fromImage(AlignedVector<char> image) {
+    std::shared_ptr<StatsPack> pack(new StatsPack());
+    pack->m_image = std::move(image);
+    pack->m_data = pack->m_image.data();
+    pack->m_size = static_cast<qint64>(pack->m_image.size());
+    if (pack->m_size < qint64(sizeof(Header)) || !pack->validate("<memory>")) {
+        return nullptr;
+    }
+    return pack;
+}
+
+bool StatsPack::writeFile(const QString& filepath, const AlignedVector<char>& image) {
+    QDir dir = QFileInfo(filepath).dir();
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qCritical() << "Failed to create cache directory:" << dir.path();
+        return false;
+    }
+
+    // Write next to the target, then swap it in. Other instances that still map
+    // the old file keep reading their (now unlinked) copy.
+    const QString tempPath = filepath + ".tmp";
+    QFile file(tempPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << "Error opening stats pack for writing:" << tempPath << file.errorString();
+        return false;
+    }
+    qint64 written = file.write(image.data(), static_cast<qint64>(image.size()));
+    file.close();
+    if (written != static_cast<qint64>(image.size())) {
+        qCritical() << "Error writing stats pack:" << tempPath;
+        QFile::remove(tempPath);
+        return false;
+    }
+
+    if (QFile::exists(filepath) && !QFile::remove(filepath)) {
+        qCritical() << "Could not replace existing stats pack (in use?):" << filepath;
+        QFile::remove(tempPath);
+        return false;
+    }
+    if (!QFile::rename(tempPath, filepath)) {
+        qCritical() << "Failed to move stats pack into place:" << filepath;
+        return false;
+    }
+    qInfo() << "Successfully saved stats pack to" << filepath << "(" << image.size() << "bytes)";
+    return true;
+}
+
+StatsPack::~StatsPack() {
+    if (m_file && m_data) {
+        m_file->unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+    }
+}
+
+
+// Checks every offset the readers will follow, so later accesses can't run off
+// the end of a mapping. Only touches the table of contents.
+bool StatsPack::validate(const QString& source) const {
+    const Header& h = header();
+    if (h.magic != MAGIC) {
+        qInfo() << "Not a mapped stats pack (magic mismatch):" << source;
+        return false;
+    }
+    if (h.version != VERSION) {
+        qWarning() << "Stats pack version mismatch (expected" << VERSION << ", got" << h.version << "):" << source;
+        return false;
+    }
+    if (h.fileSize != quint64(m_size) || h.tocSize > quint64(m_size)) {
+        qWarning() << "Stats pack size mismatch (truncated?):" << source;
+        return false;
+    }
+
+    // Everything but the per-entry arrays has to sit inside the mapped table of contents
+    auto inToc = [&h](quint64 offset, quint64 bytes) {
+        return offset <= h.tocSize && bytes <= h.tocSize - offset;
+    };
+    auto inFile = [this, &h](quint64 offset, quint64 bytes) {
+        return offset >= h.tocSize && offset <= quint64(m_size) && bytes <= quint64(m_size) - offset;
+    };
+    if (h.rankBuckets != 0 && h.rankBuckets != quint32(RankCounts::BUCKETS)) {
+        qWarning() << "Stats pack has" << h.rankBuckets << "rank buckets, expected" << RankCounts::BUCKETS << ":" << source;
+        return false;
+    }
+    if (h.brawlerCount > h.stringCount ||
+        h.brawlerCount >= INVALID_BRAWLER_ID ||
+        !inToc(h.stringIndexOffset, quint64(h.stringCount) * sizeof(StringRef)) ||
+        !inToc(h.directoryOffset, quint64(h.entryCount) * sizeof(DirEntry)) ||
+        !inToc(h.sourcesOffset, quint64(h.sourceCount) * sizeof(SourceEntry)) ||
+        h.stringIndexOffset % alignof(StringRef) != 0 ||
+        h.directoryOffset % alignof(DirEntry) != 0 ||
+        h.sourcesOffset % alignof(SourceEntry) != 0)
+    {
+        qWarning() << "Stats pack has an invalid section layout:" << source;
+        return false;
+    }
+
+    const StringRef* strings = reinterpret_cast<const StringRef*>(m_data + h.stringIndexOffset);
+    for (quint32 i = 0; i < h.stringCount; ++i) {
+        if (!inToc(h.stringDataOffset + strings[i].offset, strings[i].length)) {
+            qWarning() << "Stats pack string" << i << "out of bounds:" << source;
+            return false;
+        }
+    }
+
+    const int n = static_cast<int>(h.brawlerCount);
+    for (int i = 0; i < entryCount(); ++i) {
+        const DirEntry& e = entry(i);
+        if (e.mapString >= h.stringCount || e.modeString >= h.stringCount) {
+            qWarning() << "Stats pack directory entry" << i << "has an invalid name:" << source;
+            return false;
+        }
+        if ((e.flags & HasStats) &&
+            (!inFile(e.tablesOffset, tablesSize(n)) || !inFile(e.rawOffset, rawSize(n)) ||
+             e.tablesOffset % alignof(double) != 0 || e.rawOffset % alignof(double) != 0 ||
+             (h.rankBuckets != 0 && (!inFile(e.rankCountsOffset, rankCountsSize(n)) ||
+                                     e.rankCountsOffset % alignof(quint32) != 0))))
+        {
+            qWarning() << "Stats pack directory entry" << i << "points outside the file:" << source;
+            return false;
+        }
+    }
+
+    if (h.fingerprintCount > 0 &&
+        (h.fingerprintCount > quint64(m_size) / sizeof(quint64) ||
+         !inFile(h.fingerprintsOffset, h.fingerprintCount * sizeof(quint64)) ||
+         h.fingerprintsOffset % alignof(quint64) != 0))
+    {
+        qWarning() << "Stats pack fingerprint section points outside the file:" << source;
+        return false;
+    }
+
+    const SourceEntry* sources = reinterpret_cast<const SourceEntry*>(m_data + h.sourcesOffset);
+    for (quint32 i = 0; i < h.sourceCount; ++i) {
+        if (sources[i].nameString >= h.stringCount) {
+            qWarning() << "Stats pack source entry" << i << "has an invalid name:" << source;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// --- Accessors ---
+
+QString StatsPack::string(quint32 index) const {
+    const Header& h = header();
+    const StringRef& ref = reinterpret_cast<const StringRef*>(m_data + h.stringIndexOffset)[index];
+    return QString::fromUtf8(m_data + h.stringDataOffset + ref.offset, static_cast<qsizetype>(ref.length));
+}
+
+const StatsPack::DirEntry& StatsPack::entry(int index) const {
+    return reinterpret_cast<const DirEntry*>(m_data + header().directoryOffset)[index];
+}
+
+std::shared_ptr<const char> StatsPack::mapRange(quint64 offset, qint64 size) const {
+    auto self = shared_from_this(); // Mappings keep the pack (and its QFile) alive
+    if (!m_file) {
+        return std::shared_ptr<const char>(self, m_data + offset); // In-memory image
+    }
+
+    QMutexLocker locker(&m_fileMutex);
+    uchar* data = m_file->map(static_cast<qint64>(offset), size);
+    if (!data) {
+        qWarning() << "Failed to map stats pack range at" << offset << ":" << m_file->errorString();
+        return nullptr;
+    }
+    return std::shared_ptr<const char>(reinterpret_cast<const char*>(data), [self](const char* p) {
+        QMutexLocker unmapLocker(&self->m_fileMutex);
+        self->m_file->unmap(reinterpret_cast<uchar*>(const_cast<char*>(p)));
+    });
+}
+
+std::shared_ptr<const MapModeTables> StatsPack::loadTables(int index) const {
+    const DirEntry& e = entry(index);
+    if (!(e.flags & HasStats)) return nullptr;
+
+    const int n = static_cast<int>(header().brawlerCount);
+    std::shared_ptr<const char> block = mapRange(e.tablesOffset, tablesSize(n));
+    if (!block) return nullptr;
+
+    // The tables struct and the mapping share one lifetime
+    struct Mapped {
+        MapModeTables tables;
+        std::shared_ptr<const char> block;
+    };
+    auto mapped = std::make_shared<Mapped>();
+    mapped->block = block;
+    MapModeTables& tables = mapped->tables;
+    tables.brawlerCount = n;
+    tables.totalWeightedPlays = e.totalWeightedPlays;
+    tables.winRates = reinterpret_cast<const double*>(block.get());
+    tables.pickRates = tables.winRates + n;
+    tables.synergy = reinterpret_cast<const float*>(tables.pickRates + n);
+    tables.counter = tables.synergy + qint64(n) * n;
+    return std::shared_ptr<const MapModeTables>(mapped, &mapped->tables);
+}
+
+std::shared_ptr<const quint32> StatsPack::loadRankCounts(int index) const {
+    const DirEntry& e = entry(index);
+    if (!(e.flags & HasStats) || header().rankBuckets == 0) return nullptr;
+
+    std::shared_ptr<const char> block = mapRange(e.rankCountsOffset, rankCountsSize(static_cast<int>(header().brawlerCount)));
+    if (!block) return nullptr;
+    return std::shared_ptr<const quint32>(block, reinterpret_cast<const quint32*>(block.get()));
+}
+
+QVector<QString> StatsPack::brawlerNames() const {
+    QVector<QString> names;
+    names.reserve(header().brawlerCount);
+    for (quint32 i = 0; i < header().brawlerCount; ++i) {
+        names.append(string(i));
+    }
+    return names;
+}
+
+QHash<QString, QSet<QString>> StatsPack::discoveredMapModes() const {
+    QHash<QString, QSet<QString>> mapModes;
+    for (int i = 0; i < entryCount(); ++i) {
+        const DirEntry& e = entry(i);
+        mapModes[string(e.modeString)].insert(string(e.mapString));
+    }
+    return mapModes;
+}
+
+QHash<QString, qint64> StatsPack::ingestedOffsets() const {
+    QHash<QString, qint64> offsets;
+    const SourceEntry* sources = reinterpret_cast<const SourceEntry*>(m_data + header().sourcesOffset);
+    for (quint32 i = 0; i < header().sourceCount; ++i) {
+        offsets.insert(string(sources[i].nameString), sources[i].ingestedOffset);
+    }
+    return offsets;
+}
+
+CacheMetadata StatsPack::metadata() const {
+    CacheMetadata metadata;
+    metadata.cacheCreationTime = header().cacheCreationTime;
+    metadata.ingestedOffsets = ingestedOffsets();
+
+    const quint64 fingerprintCount = header().fingerprintCount;
+    if (fingerprintCount > 0) {
+        std::shared_ptr<const char> block = mapRange(header().fingerprintsOffset, qint64(fingerprintCount * sizeof(quint64)));
+        if (!block) {
+            throw std::runtime_error("Could not map battle fingerprints from the pack");
+        }
+        const quint64* fingerprints = reinterpret_cast<const quint64*>(block.get());
+        metadata.battleFingerprints = QVector<quint64>(fingerprints, fingerprints + fingerprintCount);
+    }
+    return metadata;
+}
+
+CacheData StatsPack::toCacheData() const {
+    const int n = static_cast<int>(header().brawlerCount);
+    const QVector<QString> names = brawlerNames();
+
+    CacheData cacheData;
+    for (int i = 0; i < entryCount(); ++i) {
+        const DirEntry& e = entry(i);
+        if (!(e.flags & HasStats)) continue;
+
+        std::shared_ptr<const char> block = mapRange(e.rawOffset, rawSize(n)); // Dropped after this entry
+        if (!block) {
+            throw std::runtime_error("Could not map raw stats from the pack"); // Caller rebuilds from source
+        }
+        const double* raw = reinterpret_cast<const double*>(block.get());
+        const double* brawlerWins = raw;
+        const double* brawlerPlays = brawlerWins + n;
+        const double* synergyWins = brawlerPlays + n;
+        const double* synergyPlays = synergyWins + qint64(n) * n;
+        const double* counterWins = synergyPlays + qint64(n) * n;
+        const double* counterPlays = counterWins + qint64(n) * n;
+
+        std::shared_ptr<const quint32> rankCounts = loadRankCounts(i);
+        if (header().rankBuckets != 0 && !rankCounts) {
+            throw std::runtime_error("Could not map rank counts from the pack");
+        }
+
+        // Zero plays means the pair/brawler never occurred (every game adds >= 0.1)
+        MapModeStatsData& target = cacheData.stats[string(e.mapString)][string(e.modeString)];
+        target.totalWeightedPlays = e.totalWeightedPlays;
+        for (int a = 0; a < n; ++a) {
+            if (brawlerPlays[a] > 0) {
+                target.brawlerStats.insert(names[a], {brawlerWins[a], brawlerPlays[a]});
+                if (rankCounts) {
+                    const quint32* wins = rankCounts.get() + qint64(a) * RankCounts::BUCKETS;
+                    const quint32* plays = wins + qint64(n) * RankCounts::BUCKETS;
+                    RankCounts& counts = target.rankCounts[names[a]];
+                    std::copy(wins, wins + RankCounts::BUCKETS, counts.wins);
+                    std::copy(plays, plays + RankCounts::BUCKETS, counts.plays);
+                }
+            }
+            for (int b = 0; b < n; ++b) {
+                qint64 cell = qint64(a) * n + b;
+                if (a < b && synergyPlays[cell] > 0) { // Synergy stored at [low id][high id]
+                    target.synergyStats.insert(sortedPairKey(names[a], names[b]), {synergyWins[cell], synergyPlays[cell]});
+                }
+                if (counterPlays[cell] > 0) {
+                    target.counterStats.insert(counterPairKey(names[a], names[b]), {counterWins[cell], counterPlays[cell]});
+                }
+            }
+        }
+    }
+
+    cacheData.allBrawlers = QSet<QString>(names.begin(), names.end());
+    cacheData.hasRankCounts = header().rankBuckets != 0;
+    cacheData.discoveredMapModes = discoveredMapModes();
+    cacheData.metadata = metadata();
+    return cacheData;
+}
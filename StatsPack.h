@@ -0,0 +1,153 @@
+#ifndef STATSPACK_H
+#define STATSPACK_H
+
+#include <QString>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <memory>
+#include <type_traits>
+#include "DataStructures.h"
+
+// Fixed-layout stats.pack that is memory-mapped and queried in place.
+//
+// Layout (native endianness, every section 64-byte aligned):
+//   Header
+//   String index   StringRef[stringCount]  (brawler names first, in BrawlerId order)
+//   String data    UTF-8 bytes
+//   Directory      DirEntry[entryCount]    (one per map/mode)
+//   Sources        SourceEntry[sourceCount] (append ingest offsets)
+//   -- end of table of contents (Header::tocSize) --
+//   Per entry:     tables  winRates[N], pickRates[N] (double), synergy[N*N], counter[N*N] (float)
+//                  raw     brawlerWins/Plays[N], synergyWins/Plays[N*N], counterWins/Plays[N*N] (double)
+//                  ranks   rankWins[N * B], rankPlays[N * B] (quint32, B = RankCounts::BUCKETS,
+//                          unweighted; absent if Header::rankBuckets is 0)
+//   Fingerprints   quint64[fingerprintCount], sorted (battles already counted, see BattleDedup)
+//
+// Opening a pack only maps the table of contents. Each entry's tables are
+// mapped on demand (loadTables) and unmapped once the last handle is dropped,
+// so resident memory follows the map/modes actually used. The raw aggregates
+// and fingerprints are only touched when re-aggregating (append ingest, config change);
+// the rank counts when StatsView applies a rank window.
+class StatsPack : public std::enable_shared_from_this<StatsPack> {
+public:
+    static constexpr quint32 MAGIC = 0x4B505347; // "GSPK"
+    // Versions 1 and 2 were the QDataStream cache (see CacheUtils), 3 had no
+    // tocSize, 4 had no battle fingerprints, 5 didn't record the rank weighting,
+    // 6 had no rank counts
+    static constexpr quint32 VERSION = 7;
+    static constexpr qint64 SECTION_ALIGNMENT = 64;
+
+    struct Header {
+        quint32 magic;
+        quint32 version;
+        quint64 fileSize;
+        quint64 tocSize; // Header + strings + directory + sources; entries start here
+        quint32 brawlerCount;
+        quint32 stringCount;
+        quint32 entryCount;
+        quint32 sourceCount;
+        quint64 stringIndexOffset;
+        quint64 stringDataOffset;
+        quint64 directoryOffset;
+        quint64 sourcesOffset;
+        quint64 fingerprintsOffset; // After the entries, outside the toc
+        quint64 fingerprintCount;
+        qint64 cacheCreationTime;
+        // Config the tables were derived with; a mismatch means re-derive from raw
+        double smoothingK;
+        double lowPickRateThreshold;
+        double lowConfidenceWinRateTarget;
+        // Rank weighting baked into the raw aggregates; a mismatch means re-aggregating the games
+        qint32 minRank;
+        qint32 maxRankConsidered;
+        double rankWeightScaleDivisor;
+        quint32 rankBuckets; // RankCounts::BUCKETS, or 0 if the entries have no rank counts
+        quint32 reserved;
+    };
+
+    struct StringRef {
+        quint32 offset; // Relative to stringDataOffset
+        quint32 length; // Bytes
+    };
+
+    enum DirFlags : quint32 {
+        HasStats = 1u << 0 // Discovered map/mode without games has no arrays
+    };
+
+    struct DirEntry {
+        quint32 mapString;
+        quint32 modeString;
+        quint32 flags;
+        quint32 reserved;
+        double totalWeightedPlays;
+        quint64 tablesOffset;
+        quint64 rawOffset;
+        quint64 rankCountsOffset; // Only valid if Header::rankBuckets != 0
+    };
+
+    struct SourceEntry {
+        quint32 nameString;
+        quint32 reserved;
+        qint64 ingestedOffset;
+    };
+
+    static_assert(std::is_trivially_copyable<Header>::value, "pack header must be POD");
+    static_assert(std::is_trivially_copyable<DirEntry>::value, "pack directory must be POD");
+
+    // Bytes of the tables / raw block for one entry with n brawlers
+    static qint64 tablesSize(int n);
+    static qint64 rawSize(int n);
+    static qint64 rankCountsSize(int n);
+    static qint64 align(qint64 offset) { return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1); }
+
+    // Maps a pack file's table of contents read-only. Returns nullptr if
+    // missing, not a pack, or corrupt.
+    static std::shared_ptr<const StatsPack> map(const QString& filepath);
+    // Wraps an image built in memory (StatsBuilder::buildPackImage)
+    static std::shared_ptr<const StatsPack> fromImage(AlignedVector<char> image);
+    // Writes an image via a temp file + rename, so running instances keep their mapping
+    static bool writeFile(const QString& filepath, const AlignedVector<char>& image);
+
+    ~StatsPack();
+    StatsPack(const StatsPack&) = delete;
+    StatsPack& operator=(const StatsPack&) = delete;
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(m_data); }
+    QString string(quint32 index) const;
+    int entryCount() const { return static_cast<int>(header().entryCount); }
+    const DirEntry& entry(int index) const;
+
+    // Maps one entry's tables (nullptr if the entry has no stats or mapping
+    // fails). The pointers stay valid while the returned handle is alive.
+    std::shared_ptr<const MapModeTables> loadTables(int index) const;
+    // Maps one entry's rank counts: wins then plays, RankCounts::BUCKETS per
+    // brawler. nullptr if the pack has none or mapping fails.
+    std::shared_ptr<const quint32> loadRankCounts(int index) const;
+
+    QVector<QString> brawlerNames() const; // Index = BrawlerId
+    QHash<QString, QSet<QString>> discoveredMapModes() const; // Mode -> maps, like DataLoader
+    QHash<QString, qint64> ingestedOffsets() const;
+    // Ingest record: creation time, offsets and battle fingerprints (maps the fingerprint section).
+    // Throws std::runtime_error if the fingerprints cannot be mapped.
+    CacheMetadata metadata() const;
+
+    // Name-keyed copy of the raw aggregates (append ingest / re-deriving tables).
+    // Throws std::runtime_error if a raw section cannot be mapped.
+    CacheData toCacheData() const;
+
+private:
+    StatsPack() = default;
+    bool validate(const QString& source) const;
+    // Read-only view of [offset, offset + size); unmapped when the last copy goes
+    std::shared_ptr<const char> mapRange(quint64 offset, qint64 size) const;
+
+    const char* m_data = nullptr;  // Table of contents (or the whole image)
+    qint64 m_size = 0;             // Whole file / image
+    std::unique_ptr<QFile> m_file; // Set when mapped; owns the mappings
+    mutable QMutex m_fileMutex;    // QFile::map/unmap aren't thread safe
+    AlignedVector<char> m_image;   // Set when built in memory
+};
+
+#endif // STATSPACK_H
@@ -0,0 +1,280 @@
+#include "StatsView.h"
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+
+StatsView::StatsView(std::shared_ptr<const StatsPack> pack, qint64 memoryBudgetBytes)
+    : m_pack(std::move(pack)),
+      m_memoryBudget(std::max<qint64>(0, memoryBudgetBytes))
+{
+    if (!m_pack) {
+        qWarning() << "StatsView created without a stats pack; all lookups use defaults.";
+        return;
+    }
+    m_registry = BrawlerRegistry(m_pack->brawlerNames());
+    m_unknownBrawlerWinRate = m_pack->header().lowConfidenceWinRateTarget;
+    m_tablesBytes = StatsPack::tablesSize(m_registry.size());
+
+    // Only the table of contents is read here; tables load on first use
+    for (int i = 0; i < m_pack->entryCount(); ++i) {
+        const StatsPack::DirEntry& entry = m_pack->entry(i);
+        const QString mode = m_pack->string(entry.modeString);
+        m_entryIndex[m_pack->string(entry.mapString)][mode] = i;
+        if (entry.flags & StatsPack::HasStats) m_modeEntries[mode].append(i);
+    }
+}
+
+StatsView::~StatsView() {
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        m_stopPrefetch = true; // Running prefetch stops after its current map
+    }
+    m_prefetchFuture.waitForFinished();
+}
+
+// --- Table Cache ---
+
+StatsView::TablesHandle StatsView::acquire(int entryIndex) const {
+    QMutexLocker locker(&m_cacheMutex);
+    auto it = m_resident.constFind(entryIndex);
+    if (it != m_resident.constEnd()) {
+        if (m_lru.first() != entryIndex) {
+            m_lru.removeOne(entryIndex);
+            m_lru.prepend(entryIndex);
+        }
+        return it.value();
+    }
+
+    TablesHandle tables = m_pack->loadTables(entryIndex);
+    if (tables && !m_rankWeights.isEmpty()) tables = rankWeightedTables(entryIndex, std::move(tables));
+    if (!tables) return nullptr; // Mapping failed, already logged
+    m_resident.insert(entryIndex, tables);
+    m_lru.prepend(entryIndex);
+    evictOverBudget(entryIndex);
+    return tables;
+}
+
+StatsView::TablesHandle StatsView::rankWeightedTables(int entryIndex, TablesHandle tables) const {
+    std::shared_ptr<const quint32> counts = m_pack->loadRankCounts(entryIndex);
+    if (!counts) return nullptr;
+    const StatsPack::Header& h = m_pack->header();
+    const int n = tables->brawlerCount;
+    const quint32* wins = counts.get();
+    const quint32* plays = wins + qint64(n) * RankCounts::BUCKETS;
+
+    // Own rate arrays; the matrices are still read from the pack's mapping
+    struct Weighted {
+        MapModeTables tables;
+        TablesHandle base;
+        QVector<double> rates; // winRates[n], pickRates[n]
+    };
+    auto weighted = std::make_shared<Weighted>();
+    weighted->tables = *tables;
+    weighted->base = std::move(tables);
+    weighted->rates.resize(2 * n);
+    double* winRates = weighted->rates.data();
+    double* pickRates = winRates + n;
+
+    // Weighted wins/plays first (in the rate arrays), then the rates themselves
+    double totalPlays = 0.0;
+    for (int b = 0; b < n; ++b) {
+        const qint64 row = qint64(b) * RankCounts::BUCKETS;
+        double w = 0.0, p = 0.0;
+        for (int r = 0; r < RankCounts::BUCKETS; ++r) {
+            w += wins[row + r] * m_rankWeights[r];
+            p += plays[row + r] * m_rankWeights[r];
+        }
+        winRates[b] = w;
+        pickRates[b] = p;
+        totalPlays += p;
+    }
+    for (int b = 0; b < n; ++b) {
+        const double pickRate = totalPlays > 0 ? pickRates[b] / totalPlays : 0.0;
+        winRates[b] = pickRates[b] > 0
+            ? adjustedWinRate(winRates[b], pickRates[b], pickRate, h.smoothingK, h.lowPickRateThreshold, h.lowConfidenceWinRateTarget)
+            : h.lowConfidenceWinRateTarget; // No games in the window, same as no stats
+        pickRates[b] = pickRate;
+    }
+
+    weighted->tables.totalWeightedPlays = totalPlays;
+    weighted->tables.winRates = winRates;
+    weighted->tables.pickRates = pickRates;
+    return TablesHandle(weighted, &weighted->tables);
+}
+
+bool StatsView::setRankWindow(const ConfigSnapshot& config) {
+    if (!m_pack) return true;
+    const bool windowed = config.rankFloor > 0 || config.rankCeiling > 0;
+
+    QVector<double> weights;
+    if (windowed && m_pack->header().rankBuckets == 0) {
+        qWarning() << "Stats pack has no rank counts (converted from an old cache); rank window not applied. Delete the cache to rebuild.";
+        return false;
+    } else if (windowed) {
+        weights.resize(RankCounts::BUCKETS);
+        for (int rank = 0; rank < RankCounts::BUCKETS; ++rank) {
+            bool inWindow = (config.rankFloor <= 0 || rank >= config.rankFloor) &&
+                            (config.rankCeiling <= 0 || rank <= config.rankCeiling);
+            weights[rank] = inWindow ? config.getRankWeight(rank) : 0.0;
+        }
+    }
+
+    QMutexLocker locker(&m_cacheMutex);
+    if (weights == m_rankWeights) return true;
+    m_rankWeights = weights;
+    m_resident.clear(); // Reloaded with the new weights on next use
+    m_lru.clear();
+    qInfo() << "Stats rank window:" << config.rankFloor << "-" << config.rankCeiling << "(0 = open)";
+    return true;
+}
+
+double StatsView::adjustedWinRate(double wins, double plays, double pickRate,
+                                  double smoothingK, double lowPickRateThreshold, double target) {
+    if (plays + smoothingK <= 0) {
+        // Avoid division by zero, apply low confidence target
+        return target;
+    }
+
+    // Calculate smoothed win rate
+    double smoothedWinRate = (wins + smoothingK * 0.5) / (plays + smoothingK);
+
+    // Adjust for confidence based on pick rate
+    double confidenceFactor = 1.0; // Default to full confidence
+    if (lowPickRateThreshold > 0.0) {
+         confidenceFactor = std::max(0.0, std::min(1.0, pickRate / lowPickRateThreshold));
+    }
+
+    double adjustedWinRate = (smoothedWinRate * confidenceFactor) + (target * (1.0 - confidenceFactor));
+
+    // Clamp final rate between 0.0 and 1.0
+    return std::max(0.0, std::min(1.0, adjustedWinRate));
+}
+
+void StatsView::evictOverBudget(int keepEntry) const {
+    if (m_memoryBudget <= 0) return;
+    // Dropping the cache's handle unmaps once no search/UI call still holds one
+    while (qint64(m_resident.size()) * m_tablesBytes > m_memoryBudget && m_lru.size() > 1) {
+        int victim = m_lru.last();
+        if (victim == keepEntry) break;
+        m_lru.removeLast();
+        m_resident.remove(victim);
+    }
+}
+
+qint64 StatsView::residentBytes() const {
+    QMutexLocker locker(&m_cacheMutex);
+    return qint64(m_resident.size()) * m_tablesBytes;
+}
+
+void StatsView::prefetchMode(const QString& mode) const {
+    if (!m_pack || !m_modeEntries.contains(mode)) return;
+    QMutexLocker locker(&m_cacheMutex);
+    if (m_stopPrefetch) return;
+    m_prefetchMode = mode;
+    if (m_prefetchRunning) return; // The running task picks the new mode up next
+    m_prefetchRunning = true;
+    m_prefetchFuture = QtConcurrent::run([this]() { runPrefetch(); });
+}
+
+void StatsView::runPrefetch() const {
+    const qint64 pageSize = 4096;
+    while (true) {
+        QString mode;
+        {
+            QMutexLocker locker(&m_cacheMutex);
+            if (m_stopPrefetch || m_prefetchMode.isEmpty()) {
+                m_prefetchRunning = false;
+                return;
+            }
+            mode = m_prefetchMode;
+            m_prefetchMode.clear();
+        }
+
+        qint64 loadedBytes = 0;
+        for (int entryIndex : m_modeEntries.value(mode)) {
+            {
+                QMutexLocker locker(&m_cacheMutex);
+                if (m_stopPrefetch || (!m_prefetchMode.isEmpty() && m_prefetchMode != mode)) break; // Superseded
+            }
+            // Don't let a big mode evict itself (or the rest of the cache) while prefetching
+            if (m_memoryBudget > 0 && loadedBytes + m_tablesBytes > m_memoryBudget) break;
+            TablesHandle tables = acquire(entryIndex);
+            if (!tables) continue;
+            loadedBytes += m_tablesBytes;
+
+            // Fault the matrices in now rather than during the first heuristic call
+            // (the rate arrays may be the view's own, see rankWeightedTables)
+            const char* bytes = reinterpret_cast<const char*>(tables->synergy);
+            const qint64 matrixBytes = 2 * qint64(tables->brawlerCount) * tables->brawlerCount * qint64(sizeof(float));
+            volatile char sink = 0;
+            for (qint64 offset = 0; offset < matrixBytes; offset += pageSize) {
+                sink = sink + bytes[offset];
+            }
+        }
+    }
+}
+
+
+// --- Stat Accessors ---
+
+StatsView::TablesHandle StatsView::getMapModeTables(const QString& mapName, const QString& mode) const {
+    return getMapModeTables(mapModeId(mapName, mode));
+}
+
+StatsView::TablesHandle StatsView::getMapModeTables(int mapModeId) const {
+    if (!m_pack || mapModeId < 0 || mapModeId >= m_pack->entryCount() ||
+        !(m_pack->entry(mapModeId).flags & StatsPack::HasStats)) {
+        return nullptr; // Unknown, or discovered without games
+    }
+    return acquire(mapModeId);
+}
+
+int StatsView::mapModeId(const QString& mapName, const QString& mode) const {
+    auto mapIt = m_entryIndex.constFind(mapName);
+    if (mapIt == m_entryIndex.constEnd()) {
+        return -1;
+    }
+    return mapIt.value().value(mode, -1);
+}
+
+QString StatsView::mapName(int mapModeId) const {
+    if (!m_pack || mapModeId < 0 || mapModeId >= m_pack->entryCount()) return QString();
+    return m_pack->string(m_pack->entry(mapModeId).mapString);
+}
+
+QString StatsView::modeName(int mapModeId) const {
+    if (!m_pack || mapModeId < 0 || mapModeId >= m_pack->entryCount()) return QString();
+    return m_pack->string(m_pack->entry(mapModeId).modeString);
+}
+
+std::optional<double> StatsView::getWinRate(const QString& brawler, const QString& mapName, const QString& mode) const {
+    TablesHandle tables = getMapModeTables(mapName, mode);
+    if (!tables) return std::nullopt; // No stats for this map/mode
+    BrawlerId id = m_registry.idOf(brawler);
+    if (id == INVALID_BRAWLER_ID) return m_unknownBrawlerWinRate; // Unknown brawler, same as no stats
+    return tables->winRate(id);
+}
+
+std::optional<double> StatsView::getPickRate(const QString& brawler, const QString& mapName, const QString& mode) const {
+    TablesHandle tables = getMapModeTables(mapName, mode);
+    if (!tables || tables->totalWeightedPlays <= 0) return std::nullopt; // No data or no plays for this map/mode
+    BrawlerId id = m_registry.idOf(brawler);
+    if (id == INVALID_BRAWLER_ID) return 0.0;
+    return tables->pickRate(id);
+}
+
+double StatsView::getSynergyScore(const QString& brawler1, const QString& brawler2, const QString& mapName, const QString& mode) const {
+    TablesHandle tables = getMapModeTables(mapName, mode);
+    BrawlerId b1 = m_registry.idOf(brawler1);
+    BrawlerId b2 = m_registry.idOf(brawler2);
+    if (!tables || b1 == INVALID_BRAWLER_ID || b2 == INVALID_BRAWLER_ID) return 0.5;
+    return tables->synergyScore(b1, b2);
+}
+
+double StatsView::getCounterScore(const QString& brawlerUs, const QString& brawlerThem, const QString& mapName, const QString& mode) const {
+    TablesHandle tables = getMapModeTables(mapName, mode);
+    BrawlerId bUs = m_registry.idOf(brawlerUs);
+    BrawlerId bThem = m_registry.idOf(brawlerThem);
+    if (!tables || bUs == INVALID_BRAWLER_ID || bThem == INVALID_BRAWLER_ID) return 0.5;
+    return tables->counterScore(bUs, bThem);
+}
@@ -0,0 +1,105 @@
+#ifndef STATSVIEW_H
+#define STATSVIEW_H
+
+#include <QHash>
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QFuture>
+#include <optional> // C++17 required
+#include <memory>
+#include "DataStructures.h"
+#include "BrawlerRegistry.h"
+#include "StatsPack.h"
+#include "AppConfig.h" // For ConfigSnapshot
+
+// Frozen, read-only stats over a StatsPack (mapped stats.pack or an image from
+// StatsBuilder). Tables are read in place; plain arrays only (no atomics, no
+// locks), so the GUI, heuristics and every MCTS worker can share one instance.
+//
+// A map/mode's tables are mapped on first access and kept in an LRU cache
+// capped by the memory budget. Only resolving a handle takes a lock; reads
+// through a handle don't.
+//
+// With a rank window (setRankWindow) the win/pick rates are recomputed from the
+// pack's per-rank counts as tables load; synergy/counter stay over all ranks.
+// The window is the one setting that changes after construction; the owner
+// sets it while no search is running.
+class StatsView {
+public:
+    using TablesHandle = std::shared_ptr<const MapModeTables>;
+
+    StatsView() = default; // Empty view: every lookup falls back to defaults
+    // Null pack -> empty view. memoryBudgetBytes caps the tables the cache keeps
+    // resident (0 = no limit); evicted tables stay valid for handles still held.
+    explicit StatsView(std::shared_ptr<const StatsPack> pack, qint64 memoryBudgetBytes = 0);
+    ~StatsView();
+    StatsView(const StatsView&) = delete;
+    StatsView& operator=(const StatsView&) = delete;
+
+    const BrawlerRegistry& brawlerRegistry() const { return m_registry; }
+    const StatsPack* pack() const { return m_pack.get(); }
+
+    // Precomputed tables for one map/mode (nullptr if no stats). Resolve once,
+    // hold the handle for as long as the pointers are used, and read entries by
+    // BrawlerId in the hot paths (Heuristics/MCTS).
+    TablesHandle getMapModeTables(const QString& mapName, const QString& mode) const;
+    TablesHandle getMapModeTables(int mapModeId) const;
+
+    // Dense ID of a map/mode (its index in the pack's directory), -1 if unknown.
+    // DraftState carries these instead of the names.
+    int mapModeId(const QString& mapName, const QString& mode) const;
+    QString mapName(int mapModeId) const;
+    QString modeName(int mapModeId) const;
+
+    // Loads and pages in every map of a mode on a worker thread, so picking
+    // the map afterwards doesn't stall the UI. A newer call replaces a pending one.
+    void prefetchMode(const QString& mode) const;
+    qint64 residentBytes() const; // Tables currently held by the cache
+
+    // Only counts players ranked config.rankFloor..config.rankCeiling (0 = open)
+    // in the win/pick rates, weighted like the pack (main.cpp rebuilds the pack
+    // if the rank weighting changed). Drops the cache; handles already handed
+    // out keep the previous rates. False if a window was asked for but the pack
+    // has no per-rank counts; the view is left unchanged then.
+    bool setRankWindow(const ConfigSnapshot& config);
+
+    // Smoothed win rate, pulled toward 'target' while the pick rate is below
+    // the threshold (shared with StatsBuilder, which fills the pack's tables)
+    static double adjustedWinRate(double wins, double plays, double pickRate,
+                                  double smoothingK, double lowPickRateThreshold, double target);
+
+    // --- Stat Accessors (name based, for the UI) ---
+    // Use std::optional to indicate if stats exist for the map/mode
+    std::optional<double> getWinRate(const QString& brawler, const QString& mapName, const QString& mode) const;
+    std::optional<double> getPickRate(const QString& brawler, const QString& mapName, const QString& mode) const;
+    // Synergy/Counter return 0.5 if no data, matching Python's behavior
+    double getSynergyScore(const QString& brawler1, const QString& brawler2, const QString& mapName, const QString& mode) const;
+    double getCounterScore(const QString& brawlerUs, const QString& brawlerThem, const QString& mapName, const QString& mode) const;
+
+private:
+    TablesHandle acquire(int entryIndex) const; // Loads on a miss, bumps the LRU
+    void evictOverBudget(int keepEntry) const;  // m_cacheMutex must be held
+    TablesHandle rankWeightedTables(int entryIndex, TablesHandle tables) const; // m_cacheMutex must be held
+    void runPrefetch() const;
+
+    std::shared_ptr<const StatsPack> m_pack;
+    BrawlerRegistry m_registry;
+    double m_unknownBrawlerWinRate = 0.0; // ConfigSnapshot::lowConfidenceWinRateTarget at build time
+    // Built from the pack's table of contents; no tables are touched up front
+    QHash<QString, QHash<QString, int>> m_entryIndex; // Map -> Mode -> directory index (with or without stats)
+    QHash<QString, QVector<int>> m_modeEntries;       // Mode -> directory indices (prefetch)
+    qint64 m_tablesBytes = 0;   // Mapped size of one entry's tables
+    qint64 m_memoryBudget = 0;  // 0 = unlimited
+
+    mutable QMutex m_cacheMutex;
+    mutable QHash<int, TablesHandle> m_resident;
+    mutable QList<int> m_lru; // Front = most recently used
+    QVector<double> m_rankWeights; // Per RankCounts bucket; empty = the pack's own rates (read under m_cacheMutex)
+    mutable QString m_prefetchMode; // Pending prefetch request
+    mutable bool m_prefetchRunning = false;
+    mutable bool m_stopPrefetch = false; // Set on destruction
+    mutable QFuture<void> m_prefetchFuture;
+};
+
+#endif // STATSVIEW_H
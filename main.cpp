@@ -1,6 +1,8 @@
 #include "MainWindow.h"
 #include "DataLoader.h"
-#include "StatsCalculator.h"
+#include "StatsBuilder.h"
+#include "StatsView.h"
+#include "StatsPack.h"
 #include "AppConfig.h"
 #include "MCTS.h"
 #include "CacheUtils.h"
@@ -19,11 +21,13 @@
 #include <QJsonArray>
 #include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 
 // --- Global Constants - File Names Only ---
 const QString DATA_FILE_NAME = "high_level_ranked_games.jsonl"; // Renamed
 const QString CACHE_FILE_NAME = "stats.pack";            // Renamed
+const QString GAMES_FILE_NAME = "games.bin";             // Games behind stats.pack, for re-aggregation
 const QString CONFIG_FILE_NAME = "draft_config.ini";         // Renamed
 const QString LOG_FILE_NAME = "draft_log.log";          // Renamed
 
@@ -84,6 +88,84 @@ void messageHandler(QtMsgType type, const QMessageLogContext &context, const QSt
 }
 
 
+// --- Append Ingest ---
+// Returns the byte offset to resume the data file from, or -1 if there is
+// nothing new (or no usable ingest record) for this source.
+static qint64 pendingIngestOffset(const QHash<QString, qint64>& ingestedOffsets, const QString& dataFilePath) {
+    if (!QFile::exists(dataFilePath)) {
+        return -1; // Cache-only install, nothing to append
+    }
+    const QString sourceKey = QFileInfo(dataFilePath).fileName();
+    auto offsetIt = ingestedOffsets.constFind(sourceKey);
+    if (offsetIt == ingestedOffsets.constEnd()) {
+        qInfo() << "Cache has no ingest record for" << sourceKey << "- skipping append (delete the cache to rebuild).";
+        return -1;
+    }
+
+    const qint64 ingested = offsetIt.value();
+    const qint64 fileSize = QFileInfo(dataFilePath).size();
+    if (fileSize < ingested) {
+        qWarning() << "Data file shrank below the ingested offset; it was probably replaced. Delete the cache to rebuild.";
+        return -1;
+    }
+    return (fileSize > ingested) ? ingested : -1;
+}
+
+// Folds games added to the data file since the cache was written into cacheData,
+// using the byte offset recorded in the cache. Returns true if the cache changed.
+// The new games are also appended to 'games' if given.
+static bool appendNewGames(CacheData& cacheData, const QString& dataFilePath, const AppConfig& config, GameTable* games = nullptr) {
+    const qint64 ingested = pendingIngestOffset(cacheData.metadata.ingestedOffsets, dataFilePath);
+    if (ingested < 0) {
+        return false;
+    }
+
+    qInfo() << "Appending" << (QFileInfo(dataFilePath).size() - ingested) << "new bytes of game data to the cache...";
+    DataLoader deltaLoader(dataFilePath, config);
+    deltaLoader.setStartOffset(ingested);
+    deltaLoader.setKnownBattles(cacheData.metadata.battleFingerprints); // Drop copies counted last time
+    StatsBuilder deltaBuilder(config.snapshot());
+    deltaLoader.loadAndProcess(deltaBuilder, games); // False here just means no usable games in the delta
+    if (deltaLoader.endOffset() <= ingested) {
+        return false; // Nothing complete to consume yet (or the read failed, already logged)
+    }
+
+    CacheData delta = deltaBuilder.getStatsForCache();
+    delta.discoveredMapModes = deltaLoader.getDiscoveredMapModes();
+    delta.metadata.ingestedOffsets.insert(QFileInfo(dataFilePath).fileName(), deltaLoader.endOffset());
+    delta.metadata.battleFingerprints = deltaLoader.battleFingerprints();
+    CacheUtils::mergeCacheData(cacheData, delta);
+
+    qInfo() << "Appended" << deltaLoader.processedGameCount() << "games; ingested up to byte" << deltaLoader.endOffset();
+    return true;
+}
+
+// Writes the builder's stats as stats.pack and maps it back, so this instance
+// shares pages with any other running one. Falls back to the in-memory image.
+static std::shared_ptr<const StatsPack> writeAndMapPack(const StatsBuilder& builder,
+                                                        const QHash<QString, QSet<QString>>& discoveredMapModes,
+                                                        CacheMetadata metadata,
+                                                        const QString& cacheFilePath) {
+    metadata.cacheCreationTime = QDateTime::currentMSecsSinceEpoch();
+    AlignedVector<char> image = builder.buildPackImage(discoveredMapModes, metadata);
+    if (StatsPack::writeFile(cacheFilePath, image)) {
+        if (auto mapped = StatsPack::map(cacheFilePath)) {
+            return mapped;
+        }
+    }
+    qWarning() << "Using in-memory stats; the pack could not be saved/mapped.";
+    return StatsPack::fromImage(std::move(image));
+}
+
+// Saves the games behind a pack; stamped with the pack's ingest record so a
+// stale file is never mistaken for the pack's games
+static void saveGames(const GameTable& games, const CacheMetadata& metadata, const QString& gamesFilePath) {
+    if (!games.writeFile(gamesFilePath, ingestStamp(metadata))) {
+        qWarning() << "Could not save" << gamesFilePath << "- changing the rank weighting will need a full rebuild.";
+    }
+}
+
+
 int main(int argc, char *argv[]) {
     // MUST be first Qt object created
     QApplication app(argc, argv);
@@ -107,6 +189,7 @@ int main(int argc, char *argv[]) {
     // --- Determine paths relative to application directory ---
     QString dataFilePath = QDir::cleanPath(appDirPath + QDir::separator() + DATA_FILE_NAME);
     QString cacheFilePath = QDir::cleanPath(appDirPath + QDir::separator() + CACHE_FILE_NAME);
+    QString gamesFilePath = QDir::cleanPath(appDirPath + QDir::separator() + GAMES_FILE_NAME);
     QString configFilePath = QDir::cleanPath(appDirPath + QDir::separator() + CONFIG_FILE_NAME);
 
     qInfo() << "Using data file:" << dataFilePath;
@@ -117,46 +200,99 @@ int main(int argc, char *argv[]) {
     AppConfig appConfig(configFilePath);
 
     // --- Initialize Core Components ---
-    std::optional<StatsCalculator> statsCalculatorOpt;
+    const ConfigSnapshot config = appConfig.snapshot();
+    std::shared_ptr<const StatsPack> statsPack;
+    std::optional<CacheData> pendingData; // Name-keyed stats that still need packing
+    std::optional<GameTable> pendingGames; // Games that changed along with pendingData
     QSet<QString> allBrawlers;
     QHash<QString, QSet<QString>> discoveredMapModes;
 
-    // --- Attempt to Load from Cache ---
+    // --- Attempt to Map the Stats Pack ---
     qInfo() << "Attempting to load data from cache...";
-    auto cachedDataOpt = CacheUtils::loadCache(cacheFilePath);
-
-    if (cachedDataOpt.has_value()) {
-        try {
-            CacheData& cachedData = cachedDataOpt.value();
-             if (cachedData.allBrawlers.isEmpty() || cachedData.discoveredMapModes.isEmpty() || cachedData.stats.isEmpty()) {
-                 qWarning() << "Cache data is incomplete. Forcing recalculation.";
-                 cachedDataOpt.reset();
-             } else {
-                 allBrawlers = cachedData.allBrawlers;
-                 discoveredMapModes = cachedData.discoveredMapModes;
-                 statsCalculatorOpt.emplace(appConfig);
-                 statsCalculatorOpt->setStatsFromCacheData(cachedData);
-                 qInfo() << "Successfully initialized components from cache.";
-             }
-        } catch (const std::exception& e) {
-             qCritical() << "Error processing loaded cache data:" << e.what() << ". Attempting recalculation.";
-             statsCalculatorOpt.reset();
-             cachedDataOpt.reset();
-        } catch (...) {
-             qCritical() << "Unknown error processing loaded cache data. Attempting recalculation.";
-             statsCalculatorOpt.reset();
-             cachedDataOpt.reset();
+    try {
+        statsPack = StatsPack::map(cacheFilePath);
+        if (statsPack) {
+            const StatsPack::Header& header = statsPack->header();
+            if (header.brawlerCount == 0 || header.entryCount == 0) {
+                qWarning() << "Cache data is incomplete. Forcing recalculation.";
+                statsPack.reset();
+            } else {
+                // Tables are derived with these settings; re-derive from the raw arrays if they changed
+                bool configChanged = header.smoothingK != config.smoothingK ||
+                                     header.lowPickRateThreshold != config.lowPickRateThreshold ||
+                                     header.lowConfidenceWinRateTarget != config.lowConfidenceWinRateTarget;
+                // The raw aggregates themselves are rank weighted; those need the games again
+                bool rankWeightingChanged = header.minRank != config.minRank ||
+                                            header.maxRankConsidered != config.maxRankConsidered ||
+                                            header.rankWeightScaleDivisor != config.rankWeightScaleDivisor;
+                bool hasNewGames = pendingIngestOffset(statsPack->ingestedOffsets(), dataFilePath) >= 0;
+                if (rankWeightingChanged) {
+                    qInfo() << "Rank weighting changed since the pack was built; re-aggregating from" << GAMES_FILE_NAME;
+                    CacheData record; // Ingest record and discoveries only; the stats come from the games
+                    record.metadata = statsPack->metadata();
+                    std::optional<GameTable> games = GameTable::mapFile(gamesFilePath, ingestStamp(record.metadata));
+                    if (games.has_value()) {
+                        const QVector<QString> names = statsPack->brawlerNames();
+                        record.allBrawlers = QSet<QString>(names.begin(), names.end());
+                        record.discoveredMapModes = statsPack->discoveredMapModes();
+                        statsPack.reset();
+                        bool appended = appendNewGames(record, dataFilePath, appConfig, &*games);
+                        StatsBuilder builder(*games, record.allBrawlers, config);
+                        statsPack = writeAndMapPack(builder, record.discoveredMapModes, record.metadata, cacheFilePath);
+                        if (appended) saveGames(*games, record.metadata, gamesFilePath);
+                    } else {
+                        qWarning() << "No usable" << GAMES_FILE_NAME << "for this pack; rebuilding from the data file.";
+                        statsPack.reset();
+                    }
+                } else if (configChanged || hasNewGames) {
+                    if (configChanged) qInfo() << "Stats settings changed since the pack was built; re-deriving tables.";
+                    pendingData = statsPack->toCacheData();
+                    if (hasNewGames) {
+                        // Keep games.bin in step with the pack if it matches it now
+                        pendingGames = GameTable::mapFile(gamesFilePath, ingestStamp(pendingData->metadata));
+                    }
+                    bool appended = appendNewGames(*pendingData, dataFilePath, appConfig, pendingGames ? &*pendingGames : nullptr);
+                    if (!appended) pendingGames.reset();
+                    statsPack.reset(); // Release the old mapping before replacing the file
+                }
+            }
+        } else {
+            // Older QDataStream cache (versions 1-2): load once and convert
+            auto legacyData = CacheUtils::loadCache(cacheFilePath);
+            if (legacyData.has_value() && !legacyData->allBrawlers.isEmpty() &&
+                !legacyData->discoveredMapModes.isEmpty() && !legacyData->stats.isEmpty()) {
+                qInfo() << "Converting legacy cache to the mapped pack format.";
+                appendNewGames(*legacyData, dataFilePath, appConfig);
+                pendingData = std::move(legacyData);
+            }
         }
-    } else {
-         qInfo() << "Cache not found or invalid.";
+
+        if (pendingData.has_value()) {
+            StatsBuilder builder(config);
+            builder.setStatsFromCacheData(*pendingData);
+            statsPack = writeAndMapPack(builder, pendingData->discoveredMapModes, pendingData->metadata, cacheFilePath);
+            if (pendingGames.has_value()) saveGames(*pendingGames, pendingData->metadata, gamesFilePath);
+        }
+        if (statsPack) qInfo() << "Successfully initialized components from cache.";
+    } catch (const std::exception& e) {
+         qCritical() << "Error processing loaded cache data:" << e.what() << ". Attempting recalculation.";
+         statsPack.reset();
+    } catch (...) {
+         qCritical() << "Unknown error processing loaded cache data. Attempting recalculation.";
+         statsPack.reset();
     }
+    pendingData.reset();
+    pendingGames.reset();
 
     // --- If Cache Failed, Load and Process Data ---
-    if (!statsCalculatorOpt.has_value()) {
+    if (!statsPack) {
         qInfo() << "Proceeding with source data loading and processing...";
         DataLoader dataLoader(dataFilePath, appConfig);
+        StatsBuilder builder(config);
+        GameTable games; // Saved as games.bin for later re-aggregation
 
-        if (!dataLoader.loadAndProcess()) {
+        qInfo() << "Initializing statistics from source data...";
+        if (!dataLoader.loadAndProcess(builder, &games)) {
             qCritical() << "Failed to load and process source data from:" << dataFilePath;
              if (!QFile::exists(dataFilePath)) {
                 QMessageBox::critical(nullptr, "Fatal Error", "Data file not found:\n" + dataFilePath + "\nPlace it in the application directory.\nApplication cannot start without data.");
@@ -166,16 +302,12 @@ int main(int argc, char *argv[]) {
             return 1;
         }
 
-        allBrawlers = dataLoader.getAllBrawlers();
-        discoveredMapModes = dataLoader.getDiscoveredMapModes();
-        const auto& processedGames = dataLoader.getProcessedGames();
-
-        if (allBrawlers.isEmpty() || discoveredMapModes.isEmpty()) {
+        if (dataLoader.getAllBrawlers().isEmpty() || dataLoader.getDiscoveredMapModes().isEmpty()) {
             qCritical() << "No brawlers or maps/modes identified after processing. Cannot proceed.";
             QMessageBox::critical(nullptr, "Fatal Error", "No usable data (brawlers/maps/modes) found.\nCheck data format and logs.\nApplication cannot start.");
             return 1;
         }
-        if (processedGames.isEmpty()) {
+        if (dataLoader.processedGameCount() == 0) {
              qWarning() << "No valid games were processed after filtering. Statistics will be minimal.";
              QMessageBox::StandardButton reply;
              reply = QMessageBox::question(nullptr, "Data Warning",
@@ -186,36 +318,38 @@ int main(int argc, char *argv[]) {
              }
         }
 
-        qInfo() << "Initializing statistics calculator from source data...";
-         statsCalculatorOpt.emplace(processedGames, appConfig);
-
-        if (statsCalculatorOpt.has_value()) {
-             qInfo() << "Attempting to save processed data to cache...";
-             CacheData dataToCache = statsCalculatorOpt->getStatsForCache();
-             dataToCache.allBrawlers = allBrawlers;
-             dataToCache.discoveredMapModes = discoveredMapModes;
-             dataToCache.metadata.cacheCreationTime = QDateTime::currentMSecsSinceEpoch();
-             CacheUtils::saveCache(cacheFilePath, dataToCache);
-        } else {
-             qCritical() << "Stats calculator failed to initialize even after data processing.";
+        qInfo() << "Attempting to save processed data to cache...";
+        CacheMetadata metadata;
+        metadata.ingestedOffsets.insert(QFileInfo(dataFilePath).fileName(), dataLoader.endOffset());
+        metadata.battleFingerprints = dataLoader.battleFingerprints();
+        statsPack = writeAndMapPack(builder, dataLoader.getDiscoveredMapModes(), metadata, cacheFilePath);
+        saveGames(games, metadata, gamesFilePath);
+        if (!statsPack) {
+             qCritical() << "Stats failed to initialize even after data processing.";
               QMessageBox::critical(nullptr, "Fatal Error", "Failed to initialize statistics engine.\nCheck logs.\nApplication cannot start.");
              return 1;
         }
     }
 
+    const QVector<QString> brawlerNames = statsPack->brawlerNames();
+    allBrawlers = QSet<QString>(brawlerNames.begin(), brawlerNames.end());
+    discoveredMapModes = statsPack->discoveredMapModes();
+
     // --- Final Sanity Check ---
-    if (!statsCalculatorOpt.has_value() || allBrawlers.isEmpty() || discoveredMapModes.isEmpty()) {
+    if (allBrawlers.isEmpty() || discoveredMapModes.isEmpty()) {
          qCritical() << "Critical error: Core data components missing before GUI launch.";
          QMessageBox::critical(nullptr, "Fatal Error", "Failed to initialize core data components.\nCheck logs.\nApplication cannot start.");
          return 1;
     }
 
-     StatsCalculator& calculator = *statsCalculatorOpt;
-     MCTSManager mctsManager(calculator, appConfig);
+     // Tables are mapped from the pack per map/mode as they're first used
+     StatsView statsView(statsPack, qint64(config.statsMemoryBudgetMB) * 1024 * 1024);
+     statsView.setRankWindow(config); // RankFloor/RankCeiling (logged if unavailable); the UI can change the floor later
+     MCTSManager mctsManager(statsView, appConfig);
 
     // --- Start GUI ---
     qInfo() << "Initializing GUI...";
-    MainWindow mainWindow(calculator, allBrawlers, discoveredMapModes, appConfig, &mctsManager);
+    MainWindow mainWindow(statsView, discoveredMapModes, appConfig, &mctsManager);
     mainWindow.show();
 
     qInfo() << "Application event loop started.";
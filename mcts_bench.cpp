@@ -0,0 +1,165 @@
+// Benchmark for the MCTS leaf evaluation modes (MctsLeafEvaluation).
+//
+// Searches a fixed set of draft positions once per mode with the same time
+// budget, and once with a long HeuristicRollout search as the reference. For
+// each mode it reports the iterations per second and how often its top pick
+// matches the reference's.
+//
+// Usage: mcts_bench [seconds per search] [reference seconds] [map/modes]
+// Reads stats.pack and draft_config.ini from the application directory, like
+// the app (build the pack by running the app once). The other MCTS settings
+// (threads, selection, ...) come from the config; the bench never saves it.
+#include "StatsPack.h"
+#include "StatsView.h"
+#include "AppConfig.h"
+#include "DraftState.h"
+#include "Heuristics.h"
+#include "MCTS.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const QString CACHE_FILE_NAME = "stats.pack";
+const QString CONFIG_FILE_NAME = "draft_config.ini";
+const int PICKS_BEFORE_SEARCH[] = {0, 1, 3, 4}; // Draft depths searched per map/mode
+
+struct BenchPosition {
+    QString label;
+    DraftState state;
+};
+
+struct SearchOutcome {
+    QString topPick; // Empty if the search returned nothing
+    long long iterations = 0;
+    double seconds = 0.0;
+};
+
+// The map/modes with the most games, each at a few depths; the picks before
+// the search are the heuristic's, so the set only depends on the pack
+QVector<BenchPosition> benchPositions(const StatsView& statsView, const HeuristicWeights& weights, int mapModeCount) {
+    QVector<QPair<double, int>> byGames;
+    for (int id = 0; id < statsView.pack()->entryCount(); ++id) {
+        StatsView::TablesHandle tables = statsView.getMapModeTables(id);
+        if (tables) byGames.append({tables->totalWeightedPlays, id});
+    }
+    std::sort(byGames.begin(), byGames.end(), [](const QPair<double, int>& a, const QPair<double, int>& b) {
+        if (a.first != b.first) return a.first > b.first;
+        return a.second < b.second;
+    });
+
+    QVector<BenchPosition> positions;
+    const int brawlerCount = statsView.brawlerRegistry().size();
+    for (int i = 0; i < std::min<int>(mapModeCount, byGames.size()); ++i) {
+        const int mapModeId = byGames[i].second;
+        const QString name = statsView.modeName(mapModeId) + "/" + statsView.mapName(mapModeId);
+        for (int picks : PICKS_BEFORE_SEARCH) {
+            DraftState state(mapModeId, brawlerCount);
+            for (int p = 0; p < picks && !state.isComplete(); ++p) {
+                BrawlerId move = bestPickHeuristic(state, statsView, weights);
+                if (move == INVALID_BRAWLER_ID) break;
+                state.push(move);
+            }
+            if (!state.isComplete()) positions.append({QString("%1 after %2 picks").arg(name).arg(picks), state});
+        }
+    }
+    return positions;
+}
+
+// Runs one search and waits for it. finalTopPick is set by the manager's
+// mctsFinalResult handler (see main).
+SearchOutcome runSearch(MCTSManager& manager, AppConfig& config, const DraftState& state, double seconds, QString& finalTopPick) {
+    // A new config version also drops the last search's trees, so every
+    // search starts from an empty tree
+    config.setMctsTimeLimit(seconds);
+
+    SearchOutcome outcome;
+    finalTopPick.clear();
+    QElapsedTimer timer;
+    timer.start();
+    manager.startMcts(state, config.heuristicWeights());
+    while (manager.isRunning()) QThread::msleep(10);
+    outcome.seconds = timer.elapsed() / 1000.0;
+    outcome.iterations = manager.iterationCount();
+    outcome.topPick = finalTopPick;
+    return outcome;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    const double budgetSeconds = argc > 1 ? QString(argv[1]).toDouble() : 2.0;
+    const double referenceSeconds = argc > 2 ? QString(argv[2]).toDouble() : 10 * budgetSeconds;
+    const int mapModeCount = argc > 3 ? QString(argv[3]).toInt() : 3;
+    if (budgetSeconds <= 0 || referenceSeconds <= 0 || mapModeCount <= 0) {
+        fprintf(stderr, "Usage: mcts_bench [seconds per search] [reference seconds] [map/modes]\n");
+        return 2;
+    }
+
+    const QString appDirPath = QCoreApplication::applicationDirPath();
+    const QString cacheFilePath = QDir::cleanPath(appDirPath + QDir::separator() + CACHE_FILE_NAME);
+    std::shared_ptr<const StatsPack> statsPack = StatsPack::map(cacheFilePath);
+    if (!statsPack) {
+        qCritical() << "No usable stats pack at" << cacheFilePath << "- run the app once to build it.";
+        return 1;
+    }
+    AppConfig config(QDir::cleanPath(appDirPath + QDir::separator() + CONFIG_FILE_NAME));
+    StatsView statsView(statsPack, qint64(config.statsMemoryBudgetMB()) * 1024 * 1024);
+    statsView.setRankWindow(config.snapshot());
+
+    MCTSManager manager(statsView, config);
+    QString finalTopPick; // Emitted from the controller thread, read once the search is done
+    QObject::connect(&manager, &MCTSManager::mctsFinalResult, [&finalTopPick](const QVector<MCTSResult>& results) {
+        finalTopPick = results.isEmpty() ? QString() : results.first().move;
+    });
+    QObject::connect(&manager, &MCTSManager::mctsError, [](const QString& error) {
+        qWarning() << "Search failed:" << error;
+    });
+
+    const QVector<BenchPosition> positions = benchPositions(statsView, config.heuristicWeights(), mapModeCount);
+    if (positions.isEmpty()) {
+        qCritical() << "The stats pack has no map/mode with stats.";
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << positions.size() << " positions, " << budgetSeconds << " s per search, reference "
+        << mctsLeafEvaluationName(MctsLeafEvaluation::HeuristicRollout) << " " << referenceSeconds << " s\n";
+
+    QVector<QString> referencePicks;
+    config.setMctsLeafEvaluation(MctsLeafEvaluation::HeuristicRollout);
+    for (const BenchPosition& position : positions) {
+        const QString topPick = runSearch(manager, config, position.state, referenceSeconds, finalTopPick).topPick;
+        referencePicks.append(topPick);
+        out << "  reference  " << position.label << ": " << (topPick.isEmpty() ? QString("(none)") : topPick) << "\n";
+        out.flush();
+    }
+
+    out << "\nmode              iter/s    top pick = reference\n";
+    for (MctsLeafEvaluation mode : {MctsLeafEvaluation::HeuristicRollout, MctsLeafEvaluation::FastRollout, MctsLeafEvaluation::Static}) {
+        config.setMctsLeafEvaluation(mode);
+        long long iterations = 0;
+        double seconds = 0.0;
+        int matches = 0;
+        for (int i = 0; i < positions.size(); ++i) {
+            SearchOutcome outcome = runSearch(manager, config, positions[i].state, budgetSeconds, finalTopPick);
+            iterations += outcome.iterations;
+            seconds += outcome.seconds;
+            if (!outcome.topPick.isEmpty() && outcome.topPick == referencePicks[i]) ++matches;
+        }
+        out << QString("%1 %2    %3/%4\n")
+                   .arg(mctsLeafEvaluationName(mode), -16)
+                   .arg(qRound64(iterations / std::max(seconds, 1e-3)), 8)
+                   .arg(matches)
+                   .arg(positions.size());
+        out.flush();
+    }
+    return 0;
+}